@@ -304,33 +304,35 @@ local statusText = CTextBuilder.begin()
 statusText:setMargin(4)
 statusBar:addChild(statusText)
 
--- Handle keyboard events
-window:onKeyboardKey(function(event)
-    if event.down then
-        -- Escape to close
-        if event.xkbKeysym == 65307 then  -- XKB_KEY_Escape
-            print("[Viewer] Escape pressed, closing...")
-            window:close()
-            backend:destroy()
-        -- Number keys 1-4 to change fit mode
-        elseif event.xkbKeysym >= 49 and event.xkbKeysym <= 52 then
-            local modeIndex = event.xkbKeysym - 49  -- 0-3
-            fitModeCombo:setCurrent(modeIndex)
-            local modes = {
-                ImageFitMode.CONTAIN,
-                ImageFitMode.COVER,
-                ImageFitMode.STRETCH,
-                ImageFitMode.TILE
-            }
-            currentFitMode = modes[modeIndex + 1]
-            if imageElement and imagePath then
-                -- Reload with new fit mode
-                loadImage(imagePath)
-            end
-            print("[Viewer] Fit mode: " .. tostring(modeIndex))
-        end
+-- Keyboard shortcuts, matched natively; only bound keys reach Lua
+local fitModes = {
+    ImageFitMode.CONTAIN,
+    ImageFitMode.COVER,
+    ImageFitMode.STRETCH,
+    ImageFitMode.TILE
+}
+
+local function selectFitMode(modeIndex)
+    fitModeCombo:setCurrent(modeIndex)
+    currentFitMode = fitModes[modeIndex + 1]
+    if imageElement and imagePath then
+        -- Reload with new fit mode
+        loadImage(imagePath)
     end
-end)
+    print("[Viewer] Fit mode: " .. tostring(modeIndex))
+end
+
+window:bindKeys({
+    ["Escape"] = function()
+        print("[Viewer] Escape pressed, closing...")
+        window:close()
+        backend:destroy()
+    end,
+    ["1"] = function() selectFitMode(0) end,
+    ["2"] = function() selectFitMode(1) end,
+    ["3"] = function() selectFitMode(2) end,
+    ["4"] = function() selectFitMode(3) end,
+})
 
 -- Handle window close request
 window:onCloseRequest(function()
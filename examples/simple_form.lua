@@ -3,22 +3,11 @@
 
 -- Create the backend (entry point)
 local backend = IBackend.create()
-local palette = backend:getPalette()
 
--- Helper function for palette text color
-local function textColor()
-    return palette.text
-end
-
--- Helper function for palette background color
-local function bgColor()
-    return palette.background
-end
-
--- Helper function for alternate base color
-local function altBaseColor()
-    return palette.alternateBase
-end
+-- Palette colors, resolved natively on every frame (no Lua calls)
+local textColor = Color.token("text")
+local bgColor = Color.token("background")
+local altBaseColor = Color.token("alternateBase")
 
 -- Create main window
 local window = CWindowBuilder.begin()
@@ -71,9 +60,7 @@ mainLayout:addChild(title)
 local subtitle = CTextBuilder.begin()
     :text("Please fill in your details below")
     :fontSize(CFontSize.new(CFontSize.HT_FONT_TEXT, 1.0))
-    :color(function()
-        return palette.text:darken(0.3)
-    end)
+    :color(Color.token("text", { darken = 0.3 }))
     :align(FontAlignment.CENTER)
     :commence()
 
@@ -82,9 +69,7 @@ mainLayout:addChild(subtitle)
 
 -- Separator line
 local separator = CRectangleBuilder.begin()
-    :color(function()
-        return palette.text:darken(0.7)
-    end)
+    :color(Color.token("text", { darken = 0.7 }))
     :size(CDynamicSize.new(
         CDynamicSize.HT_SIZE_PERCENT,
         CDynamicSize.HT_SIZE_ABSOLUTE,
@@ -160,9 +145,7 @@ local sliderLabel = CTextBuilder.begin()
 local priorityValue = CTextBuilder.begin()
     :text("5")
     :fontSize(CFontSize.new(CFontSize.HT_FONT_TEXT, 1.0))
-    :color(function()
-        return palette.accent
-    end)
+    :color(Color.token("accent"))
     :commence()
 
 local prioritySlider = CSliderBuilder.begin()
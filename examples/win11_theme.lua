@@ -172,7 +172,7 @@ local function getBatteryInfo()
     local status = readLine(batPath .. "/status")
     if capacity then
         return {
-            percent = tonumber(capacity) or 0,
+            percent = math.floor(tonumber(capacity) or 0),
             status = status or "Unknown",
             present = true
         }
@@ -183,7 +183,7 @@ local function getBatteryInfo()
     status = readLine(batPath .. "/status")
     if capacity then
         return {
-            percent = tonumber(capacity) or 0,
+            percent = math.floor(tonumber(capacity) or 0),
             status = status or "Unknown",
             present = true
         }
@@ -454,6 +454,12 @@ local navItems = {
     {label = "Windows Update"},
 }
 
+-- Shared label settings, converted once; each item only supplies its text
+local navLabelPrototype = CTextBuilder.freeze({
+    fontSize = CFontSize.new(CFontSize.HT_FONT_TEXT, 1.0),
+    color = function() return colors.text end,
+})
+
 for i, item in ipairs(navItems) do
     local isSelected = (i == 1)
 
@@ -493,11 +499,7 @@ for i, item in ipairs(navItems) do
         navItem:addChild(indicator)
     end
 
-    local navLabel = CTextBuilder.begin()
-        :text(item.label)
-        :fontSize(CFontSize.new(CFontSize.HT_FONT_TEXT, 1.0))
-        :color(function() return colors.text end)
-        :commence()
+    local navLabel = navLabelPrototype:instantiate({ text = item.label })
 
     navLabel:setMargin(16)
     navLabel:setPositionMode(PositionMode.ABSOLUTE)
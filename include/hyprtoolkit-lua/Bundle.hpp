@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct lua_State;
+
+namespace Hyprtoolkit::Lua {
+
+struct SBundleIndexEntry;
+
+enum eBundleEntryKind : uint32_t {
+    BUNDLE_MODULE = 0, // precompiled chunk, named like require() names it
+    BUNDLE_ASSET,      // raw file, named by its path relative to the packed directory
+};
+
+struct SBundlePackOptions {
+    std::string directory;
+    std::string output;
+    // Script under directory run when the bundle is the entry point
+    std::string entry = "main.lua";
+    // Drop debug info from chunks: smaller, but tracebacks lose line numbers
+    bool        strip = false;
+};
+
+// Single-file app archive: a sorted index, precompiled Lua chunks and raw assets.
+// The file is mapped read-only and looked up in place, so require() costs one binary
+// search and a luaL_loadbuffer straight from the mapping.
+class CBundle {
+  public:
+    ~CBundle();
+
+    CBundle(const CBundle&)            = delete;
+    CBundle& operator=(const CBundle&) = delete;
+
+    // Writes a bundle of every file under options.directory
+    static bool                     pack(const SBundlePackOptions& options, std::string& error);
+
+    // Cheap check of the file magic, used by CLuaState::doFile
+    static bool                     isBundle(const std::string& path);
+
+    static std::unique_ptr<CBundle> open(const std::string& path, std::string& error);
+
+    // Registers the bundle on L's state and puts its module searcher right after
+    // package.preload, ahead of the filesystem searchers
+    void                            mount(lua_State* L);
+
+    // The bundle mounted on L's state, or nullptr
+    static CBundle*                 fromState(lua_State* L);
+
+    std::string_view                module(std::string_view name) const;
+    std::string_view                asset(std::string_view name) const;
+    bool                            hasAsset(std::string_view name) const;
+    std::vector<std::string_view>   names(eBundleEntryKind kind) const;
+
+    // Module name of the entry script
+    std::string_view                entry() const;
+
+    // A real file for APIs that only take paths, like CImageBuilder. Written to the
+    // runtime dir ($XDG_RUNTIME_DIR or a private one under /tmp) on first use, keeping
+    // the extension, and removed with the bundle.
+    std::string                     assetPath(std::string_view name);
+
+    const std::string&              path() const;
+
+  private:
+    CBundle() = default;
+
+    const SBundleIndexEntry*                     findEntry(eBundleEntryKind kind, std::string_view name) const;
+
+    std::string                                  m_path;
+    const uint8_t*                               m_data  = nullptr;
+    size_t                                       m_size  = 0;
+    lua_State*                                   m_state = nullptr;
+    std::unordered_map<std::string, std::string> m_assetFiles;
+};
+
+} // namespace Hyprtoolkit::Lua
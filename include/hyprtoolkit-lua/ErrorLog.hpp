@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Hyprtoolkit::Lua {
+
+struct SErrorRecord {
+    std::string                           source;  // e.g. "colorFn", "CButtonBuilder.onMainClick"
+    std::string                           message; // Lua errors carry their chunk:line
+    uint64_t                              count = 0;
+    std::chrono::steady_clock::time_point first;
+    std::chrono::steady_clock::time_point last;
+};
+
+struct SErrorLogStats {
+    uint64_t reported   = 0;
+    uint64_t written    = 0; // lines handed to stderr, summaries included
+    uint64_t suppressed = 0; // repeats folded into a summary, or over the global rate
+    uint64_t dropped    = 0; // lines lost because the output buffer was full
+    size_t   unique     = 0; // records currently kept
+};
+
+// Error reporting for the bindings, cheap enough for callbacks that fail every frame.
+// Identical errors from the same source are folded: the first is written, repeats
+// within the window are counted and summarized once it ends, and a global cap bounds
+// the lines per second. Writing happens on a background thread, so a slow stderr
+// (e.g. a journal pipe) never stalls the UI thread. Thread safe.
+class CErrorLog {
+  public:
+    static CErrorLog& get();
+
+    void                      report(std::string_view source, std::string_view message);
+
+    // Newest first, at most max
+    std::vector<SErrorRecord> recent(size_t max = SIZE_MAX) const;
+    SErrorLogStats            stats() const;
+    void                      clear();
+
+    // Window during which repeats of one error are only counted, and the cap on lines
+    // written per second across all errors
+    void                      setLimits(std::chrono::milliseconds window, size_t linesPerSecond);
+
+    // Writes everything pending now, on the calling thread. Runs at exit.
+    void                      flush();
+
+  private:
+    CErrorLog();
+
+    struct SEntry {
+        SErrorRecord                          record;
+        std::string                           key;
+        uint64_t                              pending = 0; // repeats not written yet
+        bool                                  shown   = false;
+        std::chrono::steady_clock::time_point windowStart;
+    };
+
+    // Call with m_mutex held
+    void                                    write(std::string line);
+    bool                                    takeToken(std::chrono::steady_clock::time_point now);
+    void                                    summarize(SEntry& entry, std::chrono::steady_clock::time_point now);
+    void                                    summarizeExpired(std::chrono::steady_clock::time_point now);
+
+    // Flusher thread, started by the first report
+    void                                    run();
+
+    // Records kept for recent(); the oldest is reused past the capacity
+    static constexpr size_t                 CAPACITY   = 256;
+    static constexpr size_t                 MAX_BUFFER = 1 << 16;
+
+    mutable std::mutex                      m_mutex;
+    std::condition_variable                 m_cv;
+    std::vector<SEntry>                     m_entries;
+    size_t                                  m_next = 0; // slot reused once full
+    std::unordered_map<std::string, size_t> m_index;    // key -> slot
+    std::string                             m_buffer;   // formatted, not yet written
+    std::chrono::milliseconds               m_window{1000};
+    size_t                                  m_linesPerSecond = 20;
+    double                                  m_tokens         = 20;
+    std::chrono::steady_clock::time_point   m_refilled;
+    bool                                    m_flusherStarted = false;
+    SErrorLogStats                          m_stats;
+};
+
+} // namespace Hyprtoolkit::Lua
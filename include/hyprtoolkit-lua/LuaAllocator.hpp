@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+struct lua_State;
+
+namespace Hyprtoolkit::Lua {
+
+struct SLuaAllocatorStats {
+    struct SSizeClass {
+        size_t size  = 0; // block size in bytes
+        size_t inUse = 0; // blocks handed out to Lua
+        size_t free  = 0; // blocks on the free list
+    };
+
+    size_t                  bytesInUse        = 0;
+    size_t                  peakBytes         = 0;
+    size_t                  limit             = 0; // 0 = unlimited
+    size_t                  arenaBytes        = 0; // bytes reserved for pooled blocks
+    size_t                  largeBytes        = 0; // bytes served by malloc above the largest size class
+    size_t                  failedAllocations = 0;
+    std::vector<SSizeClass> sizeClasses;
+};
+
+// lua_Alloc implementation with an optional size-class pool and a hard memory limit.
+// Small blocks are carved from per-class arenas and recycled through free lists;
+// anything above the largest class goes to malloc. Allocations that would exceed
+// the limit fail, which Lua turns into a regular "not enough memory" error.
+// A lua_State is single-threaded, so no locking is done here.
+class CLuaAllocator {
+  public:
+    CLuaAllocator(bool pooled, size_t limit);
+    ~CLuaAllocator();
+
+    CLuaAllocator(const CLuaAllocator&)            = delete;
+    CLuaAllocator& operator=(const CLuaAllocator&) = delete;
+
+    // lua_Alloc entry point, ud is the CLuaAllocator
+    static void* alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+    // The allocator a state was created with, or nullptr for the default one
+    static CLuaAllocator* fromState(lua_State* L);
+
+    SLuaAllocatorStats stats() const;
+    void               setLimit(size_t limit);
+
+  private:
+    static constexpr size_t MAX_POOLED = 512;
+    static constexpr size_t ARENA_SIZE = 64 * 1024;
+
+    struct SFreeBlock {
+        SFreeBlock* next = nullptr;
+    };
+
+    struct SPool {
+        size_t      size     = 0;
+        SFreeBlock* freeList = nullptr;
+        char*       bump     = nullptr; // next uncarved block in the current arena
+        char*       bumpEnd  = nullptr;
+        size_t      inUse    = 0;
+        size_t      free     = 0;
+    };
+
+    void*                                allocate(size_t size);
+    void                                 release(void* ptr, size_t size);
+    void*                                reallocate(void* ptr, size_t osize, size_t nsize);
+    int                                  poolIndex(size_t size) const;
+
+    bool                                 m_pooled = false;
+    size_t                               m_limit  = 0;
+    size_t                               m_inUse  = 0;
+    size_t                               m_peak   = 0;
+    size_t                               m_large  = 0;
+    size_t                               m_failed = 0;
+
+    std::vector<SPool>                   m_pools;
+    std::array<int, MAX_POOLED / 16 + 1> m_classForSize = {};
+    std::vector<void*>                   m_arenas;
+};
+
+} // namespace Hyprtoolkit::Lua
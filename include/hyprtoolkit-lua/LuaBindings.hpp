@@ -14,11 +14,25 @@ void registerCore(sol::state& lua);
 void registerElement(sol::state& lua);
 void registerElementBuilders(sol::state& lua);
 void registerWindow(sol::state& lua);
+void registerInstrumentation(sol::state& lua);
+void registerWatchdog(sol::state& lua);
+void registerAnimation(sol::state& lua);
+void registerFs(sol::state& lua);
+void registerProcess(sol::state& lua);
+void registerTrace(sol::state& lua);
+void registerImageOps(sol::state& lua);
+void registerTasks(sol::state& lua);
+void registerBundle(sol::state& lua);
+void registerReconciler(sol::state& lua);
+void registerEvents(sol::state& lua);
+void registerTextDocument(sol::state& lua);
+void registerErrors(sol::state& lua);
 
 // Register all hyprtoolkit bindings to an existing sol::state
 void registerAllBindings(sol::state& lua);
 
 // Create a new Lua state with all hyprtoolkit bindings registered
 Hyprutils::Memory::CSharedPointer<CLuaState> createLuaState();
+Hyprutils::Memory::CSharedPointer<CLuaState> createLuaState(const SLuaStateOptions& options);
 
 } // namespace Hyprtoolkit::Lua
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <sol/sol.hpp>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "Tracer.hpp"
+#include "Watchdog.hpp"
+
+namespace Hyprtoolkit::Lua {
+
+// A global bound through CLuaState::bind. The global stays an ordinary entry of _G;
+// the slot pins the value it last saw there, and a handle compares that against the
+// raw _G entry before each call, so reassignments from Lua are picked up lazily.
+struct SLuaGlobalSlot {
+    std::string             name;
+    const char*             traceName = nullptr; // interned name, for spans and the watchdog
+    lua_State*              state     = nullptr; // null once the state is gone
+    sol::object             key;                 // name as a pinned Lua string
+    sol::object             value;
+    sol::protected_function fn;                  // value, when it is a function
+    uint64_t                generation = 0;      // bumped whenever a different value is seen
+};
+
+// Re-pins the slot if the raw _G entry no longer is its value. Returns false once the
+// state is gone.
+bool syncLuaGlobalSlot(SLuaGlobalSlot& slot);
+
+template <typename Sig>
+class CLuaFunction;
+
+// Typed handle to a bound global function, for hosts calling into Lua every frame.
+// A call checks the raw _G entry against the pinned function by identity, then calls
+// it: no metamethods, no std::function and no allocation unless it fails. It runs protected, traced and under the watchdog.
+template <typename Ret, typename... Args>
+class CLuaFunction<Ret(Args...)> {
+  public:
+    using result_type = std::expected<Ret, std::string>;
+
+    CLuaFunction() = default;
+    explicit CLuaFunction(std::shared_ptr<SLuaGlobalSlot> slot) : m_slot(std::move(slot)) {}
+
+    // False while the global isn't a function, e.g. before the script defines it
+    bool valid() const {
+        return m_slot && syncLuaGlobalSlot(*m_slot) && m_slot->fn.valid();
+    }
+
+    explicit operator bool() const {
+        return valid();
+    }
+
+    // Changes whenever Lua assigns the global a different value, for hosts caching
+    // anything derived from it
+    uint64_t generation() const {
+        if (!m_slot)
+            return 0;
+        syncLuaGlobalSlot(*m_slot);
+        return m_slot->generation;
+    }
+
+    const char* name() const {
+        return m_slot ? m_slot->name.c_str() : "(unbound)";
+    }
+
+    result_type operator()(Args... args) const {
+        if (!valid())
+            return std::unexpected(std::string(name()) + " is not a function");
+
+        CTracer::CSpan                 span(m_slot->traceName, "host");
+        CWatchdog::CScope              watchdog(m_slot->state, "host call", m_slot->traceName);
+        sol::protected_function_result result = m_slot->fn(std::forward<Args>(args)...);
+        if (!result.valid()) {
+            sol::error err = result;
+            return std::unexpected(std::string(err.what()));
+        }
+
+        if constexpr (std::is_void_v<Ret>)
+            return {};
+        else {
+            auto value = result.template get<sol::optional<Ret>>();
+            if (!value)
+                return std::unexpected(std::string(name()) + " returned " + sol::type_name(result.lua_state(), result.get_type()));
+            return std::move(*value);
+        }
+    }
+
+  private:
+    std::shared_ptr<SLuaGlobalSlot> m_slot;
+};
+
+} // namespace Hyprtoolkit::Lua
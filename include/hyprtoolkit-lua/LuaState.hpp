@@ -2,13 +2,46 @@
 
 #include <sol/sol.hpp>
 #include <hyprutils/memory/SharedPtr.hpp>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "Bundle.hpp"
+#include "LuaAllocator.hpp"
+#include "LuaFunction.hpp"
+#include "Watchdog.hpp"
+
+namespace Hyprtoolkit {
+class IBackend;
+}
 
 namespace Hyprtoolkit::Lua {
 
+class CEventQueue;
+
+using LuaEventScalar  = std::variant<std::monostate, bool, int64_t, double, std::string>;
+// A scalar, or a flat record that arrives in Lua as a table
+using LuaEventPayload = std::variant<std::monostate, bool, int64_t, double, std::string, std::vector<std::pair<std::string, LuaEventScalar>>>;
+
+struct SLuaStateOptions {
+    // Serve small allocations from size-class pools instead of the system malloc
+    bool   pooledAllocator = false;
+
+    // Hard limit on the Lua heap in bytes, 0 for unlimited.
+    // Allocations past it raise a Lua memory error instead of growing the process.
+    size_t memoryLimit = 0;
+};
+
 class CLuaState {
   public:
     CLuaState();
+    explicit CLuaState(const SLuaStateOptions& options);
     ~CLuaState();
 
     // Non-copyable
@@ -26,7 +59,7 @@ class CLuaState {
     // Open standard Lua libraries
     void openLibs();
 
-    // Execute a Lua script file
+    // Execute a Lua script file, or mount a bundle written by CBundle::pack and run its entry script
     sol::protected_function_result doFile(const std::string& path);
 
     // Execute a Lua string
@@ -47,8 +80,57 @@ class CLuaState {
     // Check if a global exists
     bool has(const std::string& name) const;
 
+    // Thread safe. Queues an event for Lua's Events.subscribe(event, fn) handlers;
+    // they receive every payload posted since the last delivery as one list.
+    void post(std::string event, LuaEventPayload payload = {});
+
+    // Deliver posted events through a backend the host created itself; backends
+    // created from Lua are picked up automatically
+    void attachBackend(const Hyprutils::Memory::CSharedPointer<IBackend>& backend);
+
+    // Resolve a global function once into a typed handle, for hosts calling it often:
+    //   auto update = state->bind<void(double)>("update");
+    //   if (auto res = update(dt); !res) log(res.error());
+    // The name may be defined by the script later; reassignments from Lua, rawset
+    // included, are picked up by existing handles on their next use. The global stays
+    // a plain _G entry, so rawget and pairs see it as usual. Handles may outlive the
+    // state, calls on them fail cleanly once it is gone.
+    template <typename Sig>
+    CLuaFunction<Sig> bind(const std::string& name) {
+        return CLuaFunction<Sig>(bindSlot(name));
+    }
+
+    // Allocator statistics, or nullopt when the state uses the default allocator
+    std::optional<SLuaAllocatorStats> allocatorStats() const;
+
+    // Abort binding callbacks that run past the given budget
+    void       enableWatchdog(const SWatchdogOptions& options = {});
+    void       disableWatchdog();
+
+    // The installed watchdog, or nullptr
+    CWatchdog* watchdog() const;
+
+    // The bundle doFile mounted, or nullptr
+    CBundle*   bundle() const;
+
   private:
-    sol::state m_lua;
+    struct SStringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view str) const {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+    using SlotMap = std::unordered_map<std::string, std::shared_ptr<SLuaGlobalSlot>, SStringHash, std::equal_to<>>;
+
+    std::shared_ptr<SLuaGlobalSlot> bindSlot(const std::string& name);
+
+    // Declared before m_lua so it outlives lua_close
+    std::unique_ptr<CLuaAllocator> m_allocator;
+    sol::state                     m_lua;
+    std::unique_ptr<CWatchdog>     m_watchdog;
+    std::unique_ptr<CBundle>       m_bundle;
+    std::shared_ptr<CEventQueue>   m_events;
+    SlotMap                        m_slots;
 };
 
 } // namespace Hyprtoolkit::Lua
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Hyprtoolkit::Lua {
+
+struct SStartupPhase {
+    std::string               name;
+    std::chrono::microseconds start{0}; // since the first recorded phase
+    std::chrono::microseconds duration{0};
+    bool                      open = true;
+};
+
+// Wall-clock timeline of process startup: openLibs, each register* step, script load
+// and the time from enterLoop to the first idle dispatch ("firstFrame").
+// Phases are recorded once; later state creations and loops don't add to it.
+class CStartupTimings {
+  public:
+    static CStartupTimings& get();
+
+    // Times the enclosing block as one phase
+    class CScope {
+      public:
+        explicit CScope(const char* name);
+        ~CScope();
+
+        CScope(const CScope&)            = delete;
+        CScope& operator=(const CScope&) = delete;
+
+      private:
+        const char* m_name = nullptr;
+    };
+
+    void                              startPhase(const std::string& name);
+    void                              endPhase(const std::string& name);
+
+    // Called once the first frame has been dispatched; ends recording
+    void                              finish();
+    bool                              finished() const;
+    void                              onFinished(std::function<void()> callback);
+
+    // Drops everything recorded and starts a new timeline, e.g. in a forked server child
+    void                              restart();
+
+    const std::vector<SStartupPhase>& phases() const;
+
+    // Human readable table, one phase per line
+    std::string                       format() const;
+
+  private:
+    CStartupTimings();
+
+    std::chrono::steady_clock::time_point m_origin;
+    std::vector<SStartupPhase>            m_phases;
+    bool                                  m_finished = false;
+    std::function<void()>                 m_onFinished;
+};
+
+} // namespace Hyprtoolkit::Lua
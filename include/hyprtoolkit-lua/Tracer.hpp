@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Hyprtoolkit::Lua {
+
+// Records what the bindings do as Chrome trace events (chrome://tracing, Perfetto).
+// Events go into a fixed-size ring buffer; when it wraps, the oldest events are
+// overwritten. Recording is lock-free and costs one relaxed load while disabled.
+// Names, categories and details must be string literals or otherwise outlive the
+// tracer; use intern() for anything else.
+class CTracer {
+  public:
+    static CTracer& get();
+
+    void enable(size_t capacity = 1 << 16);
+    void disable();
+    bool enabled() const {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    // Records a complete ("X") event for the enclosing block
+    class CSpan {
+      public:
+        CSpan(const char* name, const char* category, const char* detail = nullptr);
+        ~CSpan();
+
+        CSpan(const CSpan&)            = delete;
+        CSpan& operator=(const CSpan&) = delete;
+
+      private:
+        const char*                           m_name     = nullptr;
+        const char*                           m_category = nullptr;
+        const char*                           m_detail   = nullptr;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    void        instant(const char* name, const char* category, const char* detail = nullptr);
+    void        counter(const char* name, const char* category, double value);
+
+    // Stable pointer for a runtime string, valid for the lifetime of the process
+    const char* intern(const std::string& str);
+
+    size_t      size() const;
+    uint64_t    dropped() const;
+    void        clear();
+
+    // {"traceEvents": [...]} of everything still in the buffer, oldest first
+    std::string json() const;
+    bool        save(const std::string& path) const;
+
+  private:
+    CTracer();
+
+    struct SEvent {
+        std::atomic<uint64_t> seq{0}; // index + 1 once the slot is fully written
+        const char*           name     = nullptr;
+        const char*           category = nullptr;
+        const char*           detail   = nullptr;
+        uint64_t              ts       = 0; // microseconds since the tracer was created
+        uint64_t              dur      = 0;
+        double                value    = 0;
+        uint32_t              tid      = 0;
+        char                  phase    = 'X';
+    };
+
+    struct SBuffer {
+        std::unique_ptr<SEvent[]> events;
+        size_t                    capacity = 0;
+        std::atomic<uint64_t>     head{0};
+    };
+
+    void                                  record(char phase, const char* name, const char* category, const char* detail, uint64_t ts, uint64_t dur, double value);
+    uint64_t                              now() const;
+    uint64_t                              sinceOrigin(std::chrono::steady_clock::time_point tp) const;
+
+    std::atomic<bool>                     m_enabled{false};
+    std::atomic<SBuffer*>                 m_buffer{nullptr};
+    // Every buffer ever allocated. One replaced by enable() is never freed, a worker
+    // may still be recording into it.
+    std::vector<std::unique_ptr<SBuffer>> m_buffers;
+    std::chrono::steady_clock::time_point m_origin;
+};
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct lua_State;
+struct lua_Debug;
+
+namespace Hyprtoolkit::Lua {
+
+struct SWatchdogOptions {
+    // Wall-clock budget for a single callback invocation, 0 to disable
+    std::chrono::milliseconds timeBudget{50};
+
+    // VM instruction budget for a single callback invocation, 0 to disable
+    uint64_t instructionBudget = 0;
+
+    // VM instructions between two budget checks
+    int checkInterval = 1000;
+};
+
+struct SWatchdogViolation {
+    std::string               callback;     // e.g. "Button onMainClick"
+    std::string               source;       // chunk:line the callback was aborted at
+    std::string               traceback;
+    std::chrono::microseconds elapsed{0};
+    uint64_t                  instructions = 0;
+};
+
+// Count hook that aborts Lua callbacks running past their budget.
+// Binding callbacks arm it through CScope for the duration of one invocation;
+// nested invocations share the budget of the outermost one.
+// Under LuaJIT the hook can't see compiled code, so the JIT is turned off for as long
+// as a watchdog is installed: scripts run interpreted, but runaway loops still abort.
+class CWatchdog {
+  public:
+    CWatchdog(lua_State* L, const SWatchdogOptions& options);
+    ~CWatchdog();
+
+    CWatchdog(const CWatchdog&)            = delete;
+    CWatchdog& operator=(const CWatchdog&) = delete;
+
+    // The watchdog installed on L's state, or nullptr
+    static CWatchdog* fromState(lua_State* L);
+
+    class CScope {
+      public:
+        // what (and detail, if given) name the callback in violation reports
+        CScope(lua_State* L, const char* what, const char* detail = nullptr);
+        ~CScope();
+
+        CScope(const CScope&)            = delete;
+        CScope& operator=(const CScope&) = delete;
+
+      private:
+        CWatchdog* m_watchdog = nullptr;
+    };
+
+    const SWatchdogOptions&                options() const;
+    const std::vector<SWatchdogViolation>& violations() const;
+    void                                   clearViolations();
+
+  private:
+    static void                           hook(lua_State* L, lua_Debug* ar);
+    void                                  recordViolation(lua_State* L, lua_Debug* ar);
+    bool                                  overBudget() const;
+
+    lua_State*                            m_state = nullptr;
+    SWatchdogOptions                      m_options;
+    std::vector<SWatchdogViolation>       m_violations;
+
+    // Current invocation
+    int                                   m_depth        = 0;
+    bool                                  m_tripped      = false;
+    const char*                           m_what         = nullptr;
+    const char*                           m_detail       = nullptr;
+    uint64_t                              m_instructions = 0;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Wire format between `hyprtoolkit-lua --server` and hyprtoolkit-lua-client.
+//
+// client -> server: SForkRequest with the client's stdin, stdout and stderr attached
+//                   as SCM_RIGHTS, then `bytes` of NUL-terminated strings: the working
+//                   directory, argc arguments and envc environment entries
+// server -> client: int32 pid of the forked child, then int32 exit status once the
+//                   script returns. EOF before the status means the child died.
+
+namespace Hyprtoolkit::Lua::ForkProtocol {
+
+constexpr uint32_t MAGIC     = 0x48544c31; // "HTL1"
+constexpr int      FD_COUNT  = 3;
+constexpr uint32_t MAX_BYTES = 1024 * 1024;
+constexpr uint32_t MAX_ITEMS = 16384;
+
+struct SForkRequest {
+    uint32_t magic = MAGIC;
+    uint32_t argc  = 0;
+    uint32_t envc  = 0;
+    uint32_t bytes = 0;
+};
+
+inline bool readAll(int fd, void* data, size_t len) {
+    auto* out = static_cast<char*>(data);
+    while (len > 0) {
+        const ssize_t n = read(fd, out, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        out += n;
+        len -= n;
+    }
+    return true;
+}
+
+inline bool writeAll(int fd, const void* data, size_t len) {
+    const auto* in = static_cast<const char*>(data);
+    while (len > 0) {
+        const ssize_t n = write(fd, in, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        in += n;
+        len -= n;
+    }
+    return true;
+}
+
+inline bool socketAddress(const std::string& path, sockaddr_un& addr) {
+    if (path.empty() || path.size() >= sizeof(addr.sun_path))
+        return false;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+} // namespace Hyprtoolkit::Lua::ForkProtocol
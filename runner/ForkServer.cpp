@@ -0,0 +1,231 @@
+#include "ForkServer.hpp"
+#include "ForkProtocol.hpp"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace Hyprtoolkit::Lua {
+
+using namespace ForkProtocol;
+
+// Per read while receiving a request
+constexpr time_t             REQUEST_TIMEOUT_SECONDS = 2;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onStopSignal(int) {
+    stopRequested = 1;
+}
+
+struct SClientRequest {
+    int                      fds[FD_COUNT] = {-1, -1, -1};
+    std::string              cwd;
+    std::vector<std::string> args;
+    std::vector<std::string> env;
+
+    void                     closeFds() {
+        for (int& fd : fds) {
+            if (fd >= 0)
+                close(fd);
+            fd = -1;
+        }
+    }
+};
+
+static bool receiveRequest(int conn, SClientRequest& request) {
+    SForkRequest header;
+    char         control[CMSG_SPACE(sizeof(int) * FD_COUNT)] = {};
+    iovec        iov{.iov_base = &header, .iov_len = sizeof(header)};
+    msghdr       msg{};
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t got = 0;
+    do {
+        got = recvmsg(conn, &msg, MSG_CMSG_CLOEXEC);
+    } while (got < 0 && errno == EINTR);
+    if (got <= 0)
+        return false;
+
+    // Exactly one SCM_RIGHTS message of FD_COUNT fds is expected. Any other fd that
+    // arrived is closed here, the caller only knows about request.fds.
+    bool fdsOk = !(msg.msg_flags & MSG_CTRUNC);
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+            continue;
+
+        const size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        if (count == FD_COUNT && request.fds[0] < 0) {
+            memcpy(request.fds, CMSG_DATA(cmsg), sizeof(int) * FD_COUNT);
+            continue;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            int fd;
+            memcpy(&fd, CMSG_DATA(cmsg) + sizeof(int) * i, sizeof(int));
+            close(fd);
+        }
+        fdsOk = false;
+    }
+    if (!fdsOk)
+        return false;
+
+    // The fds come with the first bytes, the rest of the header may trail
+    if (static_cast<size_t>(got) < sizeof(header) && !readAll(conn, reinterpret_cast<char*>(&header) + got, sizeof(header) - got))
+        return false;
+
+    if (header.magic != MAGIC || request.fds[FD_COUNT - 1] < 0 || header.bytes > MAX_BYTES || header.argc > MAX_ITEMS || header.envc > MAX_ITEMS)
+        return false;
+
+    std::string blob(header.bytes, '\0');
+    if (!readAll(conn, blob.data(), blob.size()))
+        return false;
+
+    std::vector<std::string> strings;
+    for (size_t pos = 0; pos < blob.size();) {
+        const size_t end = blob.find('\0', pos);
+        if (end == std::string::npos)
+            return false;
+        strings.emplace_back(blob, pos, end - pos);
+        pos = end + 1;
+    }
+
+    if (strings.size() != 1 + header.argc + header.envc)
+        return false;
+
+    request.cwd = std::move(strings[0]);
+    request.args.assign(std::make_move_iterator(strings.begin() + 1), std::make_move_iterator(strings.begin() + 1 + header.argc));
+    request.env.assign(std::make_move_iterator(strings.begin() + 1 + header.argc), std::make_move_iterator(strings.end()));
+    return true;
+}
+
+// In the child: become the client's process as far as the script can tell
+[[noreturn]] static void runChild(int conn, SClientRequest& request, const std::function<int(const std::vector<std::string>&)>& run) {
+    signal(SIGCHLD, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+
+    for (int i = 0; i < FD_COUNT; ++i) {
+        dup2(request.fds[i], i);
+    }
+    request.closeFds();
+
+    if (chdir(request.cwd.c_str()) != 0)
+        fprintf(stderr, "[fork-server] chdir %s failed: %s\n", request.cwd.c_str(), strerror(errno));
+
+    clearenv();
+    for (const auto& entry : request.env) {
+        const size_t eq = entry.find('=');
+        if (eq != std::string::npos && eq > 0)
+            setenv(entry.substr(0, eq).c_str(), entry.c_str() + eq + 1, 1);
+    }
+
+    const int32_t pid = getpid();
+    writeAll(conn, &pid, sizeof(pid));
+
+    const int32_t status = run(request.args);
+    writeAll(conn, &status, sizeof(status));
+    std::exit(status);
+}
+
+int runForkServer(const std::string& socketPath, const std::function<int(const std::vector<std::string>& args)>& run) {
+    sockaddr_un addr;
+    if (!socketAddress(socketPath, addr)) {
+        fprintf(stderr, "[fork-server] invalid socket path: %s\n", socketPath.c_str());
+        return 1;
+    }
+
+    const int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        fprintf(stderr, "[fork-server] socket failed: %s\n", strerror(errno));
+        return 1;
+    }
+
+    // Only a stale socket of ours is replaced, never a file a mistyped path points at
+    struct stat existing;
+    if (lstat(socketPath.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode) || existing.st_uid != geteuid()) {
+            fprintf(stderr, "[fork-server] %s exists and is not our socket, refusing to replace it\n", socketPath.c_str());
+            close(listenFd);
+            return 1;
+        }
+        unlink(socketPath.c_str());
+    }
+
+    // Anyone who can connect runs code as us: the socket is created 0600 rather than
+    // chmod-ed after bind, so there is no window where others can reach it
+    const mode_t oldMask = umask(077);
+    const bool   bound   = bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    umask(oldMask);
+    if (!bound || listen(listenFd, 16) != 0) {
+        fprintf(stderr, "[fork-server] cannot listen on %s: %s\n", socketPath.c_str(), strerror(errno));
+        close(listenFd);
+        return 1;
+    }
+
+    // Children report to their client directly, nobody waits for them here
+    signal(SIGCHLD, SIG_IGN);
+
+    struct sigaction stop{};
+    stop.sa_handler = onStopSignal;
+    sigemptyset(&stop.sa_mask);
+    sigaction(SIGINT, &stop, nullptr);
+    sigaction(SIGTERM, &stop, nullptr);
+
+    while (!stopRequested) {
+        const int conn = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (conn < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            fprintf(stderr, "[fork-server] accept failed: %s\n", strerror(errno));
+            break;
+        }
+
+        // Permissions on the path are the first line, the peer's uid the second
+        ucred     peer{};
+        socklen_t peerLen = sizeof(peer);
+        if (getsockopt(conn, SOL_SOCKET, SO_PEERCRED, &peer, &peerLen) != 0 || peer.uid != geteuid()) {
+            fprintf(stderr, "[fork-server] rejected a connection from another user\n");
+            close(conn);
+            continue;
+        }
+
+        // The request is read here in the accept loop, a client that stalls mid-request
+        // must not hold up everyone else for long
+        const timeval timeout{.tv_sec = REQUEST_TIMEOUT_SECONDS, .tv_usec = 0};
+        setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        SClientRequest request;
+        if (!receiveRequest(conn, request)) {
+            fprintf(stderr, "[fork-server] malformed request\n");
+            request.closeFds();
+            close(conn);
+            continue;
+        }
+
+        const pid_t pid = fork();
+        if (pid == 0) {
+            close(listenFd);
+            runChild(conn, request, run);
+        }
+
+        if (pid < 0)
+            fprintf(stderr, "[fork-server] fork failed: %s\n", strerror(errno));
+
+        request.closeFds();
+        close(conn);
+    }
+
+    close(listenFd);
+    unlink(socketPath.c_str());
+    return stopRequested ? 0 : 1;
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Hyprtoolkit::Lua {
+
+// Listens on a Unix socket and forks one child per client request. The caller sets up
+// everything worth sharing (Lua state, bindings) before calling this; each child gets
+// the client's stdio, working directory and environment, runs `run` with the client's
+// arguments and exits with its result. Only returns on error or SIGINT/SIGTERM.
+int runForkServer(const std::string& socketPath, const std::function<int(const std::vector<std::string>& args)>& run);
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,123 @@
+#include "ForkProtocol.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+// Thin client for `hyprtoolkit-lua --server`: links nothing but libc, so a keybind
+// pays only for the connect and the fork on the server side. Without a server it
+// execs the regular runner instead.
+
+using namespace Hyprtoolkit::Lua::ForkProtocol;
+
+static volatile sig_atomic_t childPid = 0;
+
+static void forwardSignal(int sig) {
+    if (childPid > 0)
+        kill(childPid, sig);
+}
+
+static int connectTo(const std::string& path) {
+    sockaddr_un addr;
+    if (!socketAddress(path, addr))
+        return -1;
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool sendRequest(int fd, int argc, char* argv[]) {
+    std::string blob;
+    char        cwd[4096];
+    blob.append(getcwd(cwd, sizeof(cwd)) ? cwd : "/");
+    blob.push_back('\0');
+    for (int i = 0; i < argc; ++i) {
+        blob.append(argv[i]);
+        blob.push_back('\0');
+    }
+
+    uint32_t envc = 0;
+    for (char** env = environ; *env; ++env, ++envc) {
+        blob.append(*env);
+        blob.push_back('\0');
+    }
+
+    if (blob.size() > MAX_BYTES)
+        return false;
+
+    SForkRequest header{.argc = static_cast<uint32_t>(argc), .envc = envc, .bytes = static_cast<uint32_t>(blob.size())};
+    const int    fds[FD_COUNT] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+    char         control[CMSG_SPACE(sizeof(fds))] = {};
+    iovec        iov{.iov_base = &header, .iov_len = sizeof(header)};
+    msghdr       msg{};
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    cmsghdr* cmsg    = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_RIGHTS;
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    ssize_t sent = 0;
+    do {
+        sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    if (sent <= 0)
+        return false;
+
+    return (static_cast<size_t>(sent) == sizeof(header) || writeAll(fd, reinterpret_cast<char*>(&header) + sent, sizeof(header) - sent)) &&
+        writeAll(fd, blob.data(), blob.size());
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <socket> [runner options] <script.lua> [args...]\n", argv[0]);
+        return 1;
+    }
+
+    const std::string socketPath = argv[1];
+    const int         fd         = connectTo(socketPath);
+    if (fd < 0) {
+        // No server running, start the script the slow way
+        argv[1] = const_cast<char*>("hyprtoolkit-lua");
+        execvp(argv[1], argv + 1);
+        fprintf(stderr, "%s: no server on %s and hyprtoolkit-lua not found\n", argv[0], socketPath.c_str());
+        return 1;
+    }
+
+    if (!sendRequest(fd, argc - 2, argv + 2)) {
+        fprintf(stderr, "%s: failed to send request\n", argv[0]);
+        return 1;
+    }
+
+    int32_t pid = 0;
+    if (!readAll(fd, &pid, sizeof(pid))) {
+        fprintf(stderr, "%s: server did not start the script\n", argv[0]);
+        return 1;
+    }
+
+    // Ctrl-C and friends go to the script, as if it ran in this process
+    childPid = pid;
+    for (const int sig : {SIGINT, SIGTERM, SIGHUP}) {
+        signal(sig, forwardSignal);
+    }
+
+    int32_t status = 0;
+    if (!readAll(fd, &status, sizeof(status))) {
+        fprintf(stderr, "%s: script process %d exited abnormally\n", argv[0], pid);
+        return 1;
+    }
+    return status;
+}
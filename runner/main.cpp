@@ -1,23 +1,99 @@
+#include <hyprtoolkit-lua/Bundle.hpp>
 #include <hyprtoolkit-lua/LuaBindings.hpp>
+#include <hyprtoolkit-lua/StartupTimings.hpp>
+#include <hyprtoolkit-lua/Tracer.hpp>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <vector>
 
-int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <script.lua> [args...]" << std::endl;
-        return 1;
+#include "ForkServer.hpp"
+
+static void printUsage(const char* self) {
+    std::cerr << "Usage: " << self << " [options] <script.lua> [args...]\n"
+              << "       " << self << " [state options] --server <socket>\n"
+              << "       " << self << " pack <dir> <out.htlb> [entry.lua] [--strip]\n"
+              << "Options:\n"
+              << "  --pooled-alloc         serve Lua allocations from size-class pools\n"
+              << "  --memory-limit <MiB>   fail Lua allocations past this heap size\n"
+              << "  --watchdog <ms>        abort callbacks running longer than this\n"
+              << "  --timings              print startup phase timings after the first frame\n"
+              << "  --trace <file>         record a Chrome trace of callbacks and GC, written at exit\n"
+              << "  --server <socket>      keep an initialized state and fork it for each hyprtoolkit-lua-client request" << std::endl;
+}
+
+struct SRunnerOptions {
+    Hyprtoolkit::Lua::SLuaStateOptions state;
+    bool                               stateOptionsSet = false;
+    int                                watchdogMs      = 0;
+    bool                               timings         = false;
+    std::string                        tracePath;
+    std::string                        serverSocket;
+};
+
+// Parses the options in front of the script; false after printing an error
+static bool parseOptions(const std::vector<std::string>& args, SRunnerOptions& options, size_t& scriptIdx) {
+    for (; scriptIdx < args.size() && args[scriptIdx].starts_with("--"); ++scriptIdx) {
+        const std::string& opt     = args[scriptIdx];
+        const bool         hasNext = scriptIdx + 1 < args.size();
+        if (opt == "--pooled-alloc") {
+            options.state.pooledAllocator = true;
+            options.stateOptionsSet       = true;
+        } else if (opt == "--timings")
+            options.timings = true;
+        else if (opt == "--memory-limit" && hasNext) {
+            try {
+                options.state.memoryLimit = std::stoull(args[++scriptIdx]) * 1024 * 1024;
+                options.stateOptionsSet   = true;
+            } catch (...) {
+                std::cerr << "Invalid --memory-limit: " << args[scriptIdx] << std::endl;
+                return false;
+            }
+        } else if (opt == "--watchdog" && hasNext) {
+            try {
+                options.watchdogMs = std::stoi(args[++scriptIdx]);
+            } catch (...) {
+                std::cerr << "Invalid --watchdog: " << args[scriptIdx] << std::endl;
+                return false;
+            }
+        } else if (opt == "--trace" && hasNext)
+            options.tracePath = args[++scriptIdx];
+        else if (opt == "--server" && hasNext)
+            options.serverSocket = args[++scriptIdx];
+        else {
+            printUsage(args[0].c_str());
+            return false;
+        }
     }
+    return true;
+}
+
+// Runs args[scriptIdx] with the rest as its arguments, on an already created state
+static int runScript(const Hyprutils::Memory::CSharedPointer<Hyprtoolkit::Lua::CLuaState>& luaState, const SRunnerOptions& options, const std::vector<std::string>& args,
+                     size_t scriptIdx) {
+    auto& startup = Hyprtoolkit::Lua::CStartupTimings::get();
+    if (options.timings)
+        startup.onFinished([&startup]() { std::cerr << "Startup timings:\n" << startup.format() << std::flush; });
 
-    auto luaState = Hyprtoolkit::Lua::createLuaState();
+    if (options.watchdogMs > 0)
+        luaState->enableWatchdog({.timeBudget = std::chrono::milliseconds(options.watchdogMs)});
 
     // Set up the arg table (Lua standard: arg[0] = script, arg[1..n] = arguments)
     sol::table argTable = luaState->lua().create_table();
-    argTable[0] = argv[1];  // Script name
-    for (int i = 2; i < argc; ++i) {
-        argTable[i - 1] = argv[i];  // Additional arguments
+    argTable[0] = args[scriptIdx];  // Script name
+    for (size_t i = scriptIdx + 1; i < args.size(); ++i) {
+        argTable[i - scriptIdx] = args[i];  // Additional arguments
     }
     luaState->lua()["arg"] = argTable;
 
-    auto result = luaState->doFile(argv[1]);
+    auto result = luaState->doFile(args[scriptIdx]);
+
+    // Scripts that never enter the loop have no first frame, report what there is
+    startup.finish();
+
+    if (!options.tracePath.empty() && !Hyprtoolkit::Lua::CTracer::get().save(options.tracePath))
+        std::cerr << "Failed to write trace to " << options.tracePath << std::endl;
+
     if (!result.valid()) {
         sol::error err = result;
         std::cerr << "Lua error: " << err.what() << std::endl;
@@ -26,3 +102,97 @@ int main(int argc, char* argv[]) {
 
     return 0;
 }
+
+// Everything up to the first frame that doesn't depend on the script happens once here;
+// children only connect to the compositor and run their script.
+static int runServer(const SRunnerOptions& serverOptions) {
+    auto luaState = Hyprtoolkit::Lua::createLuaState(serverOptions.state);
+
+    // Start children from a compact heap, pages they don't touch stay shared
+    luaState->lua().collect_garbage();
+
+    std::cerr << "hyprtoolkit-lua: serving on " << serverOptions.serverSocket << std::endl;
+    return Hyprtoolkit::Lua::runForkServer(serverOptions.serverSocket, [&luaState](const std::vector<std::string>& request) {
+        // Time this request, not the server's startup
+        Hyprtoolkit::Lua::CStartupTimings::get().restart();
+
+        std::vector<std::string> args{"hyprtoolkit-lua"};
+        args.insert(args.end(), request.begin(), request.end());
+
+        SRunnerOptions options;
+        size_t         scriptIdx = 1;
+        if (!parseOptions(args, options, scriptIdx))
+            return 1;
+        if (scriptIdx >= args.size()) {
+            printUsage(args[0].c_str());
+            return 1;
+        }
+        if (options.stateOptionsSet || !options.serverSocket.empty())
+            std::cerr << "Allocator and server options only apply to the server, ignoring them" << std::endl;
+        if (!options.tracePath.empty())
+            Hyprtoolkit::Lua::CTracer::get().enable();
+
+        return runScript(luaState, options, args, scriptIdx);
+    });
+}
+
+// hyprtoolkit-lua pack <dir> <out> [entry.lua] [--strip]
+static int runPack(const std::vector<std::string>& args) {
+    Hyprtoolkit::Lua::SBundlePackOptions pack;
+    std::vector<std::string>             positional;
+    for (size_t i = 2; i < args.size(); ++i) {
+        if (args[i] == "--strip")
+            pack.strip = true;
+        else
+            positional.push_back(args[i]);
+    }
+
+    if (positional.size() < 2 || positional.size() > 3) {
+        printUsage(args[0].c_str());
+        return 1;
+    }
+
+    pack.directory = positional[0];
+    pack.output    = positional[1];
+    if (positional.size() == 3)
+        pack.entry = positional[2];
+
+    std::string error;
+    if (!Hyprtoolkit::Lua::CBundle::pack(pack, error)) {
+        std::cerr << "pack: " << error << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    const std::vector<std::string> args(argv, argv + argc);
+    SRunnerOptions                 options;
+    size_t                         scriptIdx = 1;
+
+    if (args.size() > 1 && args[1] == "pack")
+        return runPack(args);
+
+    if (!parseOptions(args, options, scriptIdx))
+        return 1;
+
+    if (!options.serverSocket.empty()) {
+        if (scriptIdx < args.size()) {
+            std::cerr << "--server takes no script, run scripts with hyprtoolkit-lua-client" << std::endl;
+            return 1;
+        }
+        return runServer(options);
+    }
+
+    if (scriptIdx >= args.size()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Enabled before the state exists so startup callbacks are traced as well
+    if (!options.tracePath.empty())
+        Hyprtoolkit::Lua::CTracer::get().enable();
+
+    auto luaState = Hyprtoolkit::Lua::createLuaState(options.state);
+    return runScript(luaState, options, args, scriptIdx);
+}
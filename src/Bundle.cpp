@@ -0,0 +1,366 @@
+#include <hyprtoolkit-lua/Bundle.hpp>
+
+#include <sol/sol.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <tuple>
+
+#include "helpers/RuntimeImage.hpp"
+
+namespace Hyprtoolkit::Lua {
+
+// File layout: SBundleHeader, count SBundleIndexEntry sorted by (kind, name), the
+// names, then the data of each entry at 8-byte alignment. Offsets are from the file
+// start. Chunks are VM bytecode, so a bundle only loads into the VM that packed it.
+
+static constexpr char     BUNDLE_MAGIC[8] = {'H', 'T', 'L', 'B', 'U', 'N', 'D', 'L'};
+static constexpr uint32_t BUNDLE_VERSION  = 1;
+static constexpr uint32_t NO_ENTRY        = UINT32_MAX;
+
+#ifdef HYPRTOOLKIT_LUA_LUAJIT
+static constexpr uint32_t BUNDLE_VM     = 0x4A4954; // "JIT"
+static constexpr auto     SEARCHERS     = "loaders";
+static constexpr auto     SEARCHER_MISS = "\n\tno module '%s' in bundle";
+#else
+static constexpr uint32_t BUNDLE_VM     = LUA_VERSION_NUM;
+static constexpr auto     SEARCHERS     = "searchers";
+static constexpr auto     SEARCHER_MISS = "no module '%s' in bundle";
+#endif
+
+struct SBundleHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t vm;
+    uint32_t count;
+    uint32_t entry;
+};
+
+struct SBundleIndexEntry {
+    uint32_t kind;
+    uint32_t nameSize;
+    uint64_t nameOffset;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+};
+
+// Address used as the registry key for the mounted bundle
+static const char BUNDLE_KEY = 0;
+
+static const SBundleIndexEntry* indexOf(const uint8_t* data) {
+    return reinterpret_cast<const SBundleIndexEntry*>(data + sizeof(SBundleHeader));
+}
+
+static std::string_view nameOf(const uint8_t* data, const SBundleIndexEntry& entry) {
+    return {reinterpret_cast<const char*>(data + entry.nameOffset), entry.nameSize};
+}
+
+static int dumpWriter(lua_State*, const void* p, size_t size, void* ud) {
+    static_cast<std::string*>(ud)->append(static_cast<const char*>(p), size);
+    return 0;
+}
+
+// "ui/button.lua" -> "ui.button", "ui/init.lua" -> "ui"
+static std::string moduleName(std::string rel) {
+    rel.resize(rel.size() - 4);
+    if (rel == "init")
+        return rel;
+    if (rel.ends_with("/init"))
+        rel.resize(rel.size() - 5);
+    std::ranges::replace(rel, '/', '.');
+    return rel;
+}
+
+bool CBundle::pack(const SBundlePackOptions& options, std::string& error) {
+    namespace fs = std::filesystem;
+
+    struct SItem {
+        uint32_t    kind = BUNDLE_MODULE;
+        std::string name;
+        std::string data;
+    };
+
+    std::error_code ec;
+    const fs::path  root = fs::weakly_canonical(options.directory, ec);
+    if (ec || !fs::is_directory(root)) {
+        error = "not a directory: " + options.directory;
+        return false;
+    }
+
+    const fs::path     output = fs::weakly_canonical(options.output, ec);
+    std::vector<SItem> items;
+    lua_State*         L = luaL_newstate();
+
+    for (const auto& file : fs::recursive_directory_iterator(root, fs::directory_options::skip_permission_denied)) {
+        if (!file.is_regular_file() || file.path() == output)
+            continue;
+
+        std::ifstream in(file.path(), std::ios::binary);
+        std::string   contents{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        std::string   rel = file.path().lexically_relative(root).generic_string();
+
+        if (!rel.ends_with(".lua")) {
+            items.push_back(SItem{BUNDLE_ASSET, std::move(rel), std::move(contents)});
+            continue;
+        }
+
+        // Precompile, so loading skips the parser. The chunk name keeps tracebacks readable.
+        const std::string chunkName = "@" + rel;
+        if (luaL_loadbufferx(L, contents.data(), contents.size(), chunkName.c_str(), "t") != LUA_OK) {
+            error = lua_tostring(L, -1);
+            lua_close(L);
+            return false;
+        }
+
+        std::string bytecode;
+#ifdef HYPRTOOLKIT_LUA_LUAJIT
+        lua_dump(L, dumpWriter, &bytecode);
+#else
+        lua_dump(L, dumpWriter, &bytecode, options.strip);
+#endif
+        lua_pop(L, 1);
+        items.push_back(SItem{BUNDLE_MODULE, moduleName(rel), std::move(bytecode)});
+    }
+    lua_close(L);
+
+    std::ranges::sort(items, [](const SItem& a, const SItem& b) { return std::tie(a.kind, a.name) < std::tie(b.kind, b.name); });
+    for (size_t i = 1; i < items.size(); ++i) {
+        if (items[i].kind == items[i - 1].kind && items[i].name == items[i - 1].name) {
+            error = "two files map to module '" + items[i].name + "'";
+            return false;
+        }
+    }
+
+    SBundleHeader header{};
+    memcpy(header.magic, BUNDLE_MAGIC, sizeof(header.magic));
+    header.version = BUNDLE_VERSION;
+    header.vm      = BUNDLE_VM;
+    header.count   = items.size();
+    header.entry   = NO_ENTRY;
+
+    const std::string entryModule = options.entry.ends_with(".lua") ? moduleName(options.entry) : options.entry;
+
+    std::vector<SBundleIndexEntry> index(items.size());
+    std::string                    names;
+    uint64_t                       namesStart = sizeof(SBundleHeader) + sizeof(SBundleIndexEntry) * items.size();
+    for (size_t i = 0; i < items.size(); ++i) {
+        index[i].kind       = items[i].kind;
+        index[i].nameSize   = items[i].name.size();
+        index[i].nameOffset = namesStart + names.size();
+        names += items[i].name;
+        if (items[i].kind == BUNDLE_MODULE && items[i].name == entryModule)
+            header.entry = i;
+    }
+
+    if (header.entry == NO_ENTRY) {
+        error = "entry script " + options.entry + " not found in " + options.directory;
+        return false;
+    }
+
+    uint64_t offset = namesStart + names.size();
+    for (size_t i = 0; i < items.size(); ++i) {
+        offset              = (offset + 7) & ~uint64_t{7};
+        index[i].dataOffset = offset;
+        index[i].dataSize   = items[i].data.size();
+        offset += items[i].data.size();
+    }
+
+    std::ofstream out(options.output, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(index.data()), sizeof(SBundleIndexEntry) * index.size());
+    out.write(names.data(), names.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        const auto pad = index[i].dataOffset - static_cast<uint64_t>(out.tellp());
+        out.write("\0\0\0\0\0\0\0", pad);
+        out.write(items[i].data.data(), items[i].data.size());
+    }
+
+    if (!out) {
+        error = "failed to write " + options.output;
+        return false;
+    }
+    return true;
+}
+
+bool CBundle::isBundle(const std::string& path) {
+    char          magic[sizeof(BUNDLE_MAGIC)] = {};
+    std::ifstream in(path, std::ios::binary);
+    return in.read(magic, sizeof(magic)) && !memcmp(magic, BUNDLE_MAGIC, sizeof(magic));
+}
+
+std::unique_ptr<CBundle> CBundle::open(const std::string& path, std::string& error) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "cannot open " + path + ": " + strerror(errno);
+        return nullptr;
+    }
+
+    struct stat st{};
+    fstat(fd, &st);
+    const size_t size = st.st_size;
+    void*        data = size >= sizeof(SBundleHeader) ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        error = path + " is not a bundle";
+        return nullptr;
+    }
+
+    auto bundle    = std::unique_ptr<CBundle>(new CBundle());
+    bundle->m_path = path;
+    bundle->m_data = static_cast<const uint8_t*>(data);
+    bundle->m_size = size;
+
+    // Validate everything once, lookups trust the index afterwards
+    const auto* header = reinterpret_cast<const SBundleHeader*>(data);
+    if (memcmp(header->magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) || header->version != BUNDLE_VERSION) {
+        error = path + " is not a bundle";
+        return nullptr;
+    }
+    if (header->vm != BUNDLE_VM) {
+        error = path + " was packed for a different Lua VM, repack it";
+        return nullptr;
+    }
+    if ((size - sizeof(SBundleHeader)) / sizeof(SBundleIndexEntry) < header->count || (header->entry != NO_ENTRY && header->entry >= header->count)) {
+        error = path + " is truncated";
+        return nullptr;
+    }
+
+    const auto* index = indexOf(bundle->m_data);
+    for (uint32_t i = 0; i < header->count; ++i) {
+        const auto& entry = index[i];
+        if (entry.nameOffset > size || entry.nameSize > size - entry.nameOffset || entry.dataOffset > size || entry.dataSize > size - entry.dataOffset) {
+            error = path + " is truncated";
+            return nullptr;
+        }
+    }
+
+    // Modules are read once each, let the kernel fetch ahead
+    madvise(data, size, MADV_WILLNEED);
+    return bundle;
+}
+
+CBundle::~CBundle() {
+    if (m_state && fromState(m_state) == this) {
+        lua_pushnil(m_state);
+        lua_rawsetp(m_state, LUA_REGISTRYINDEX, &BUNDLE_KEY);
+    }
+
+    for (const auto& [name, file] : m_assetFiles) {
+        unlink(file.c_str());
+    }
+
+    if (m_data)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+}
+
+static int searchBundle(lua_State* L) {
+    const char* name   = luaL_checkstring(L, 1);
+    auto*       bundle = CBundle::fromState(L);
+    const auto  chunk  = bundle ? bundle->module(name) : std::string_view{};
+    if (chunk.empty()) {
+        lua_pushfstring(L, SEARCHER_MISS, name);
+        return 1;
+    }
+
+    // Straight from the mapping, the loader copies what it keeps
+    if (luaL_loadbufferx(L, chunk.data(), chunk.size(), name, "b") != LUA_OK)
+        return luaL_error(L, "error loading module '%s' from bundle:\n\t%s", name, lua_tostring(L, -1));
+
+    lua_pushfstring(L, "%s:%s", bundle->path().c_str(), name);
+    return 2;
+}
+
+void CBundle::mount(lua_State* L) {
+    m_state = sol::main_thread(L, L);
+    lua_pushlightuserdata(m_state, this);
+    lua_rawsetp(m_state, LUA_REGISTRYINDEX, &BUNDLE_KEY);
+
+    sol::state_view lua(m_state);
+    sol::table      searchers = lua["package"][SEARCHERS];
+    lua["table"]["insert"](searchers, 2, &searchBundle);
+}
+
+CBundle* CBundle::fromState(lua_State* L) {
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &BUNDLE_KEY);
+    auto* bundle = static_cast<CBundle*>(lua_touserdata(L, -1));
+    lua_pop(L, 1);
+    return bundle;
+}
+
+const SBundleIndexEntry* CBundle::findEntry(eBundleEntryKind kind, std::string_view name) const {
+    const auto* header = reinterpret_cast<const SBundleHeader*>(m_data);
+    const auto* begin  = indexOf(m_data);
+    const auto* end    = begin + header->count;
+
+    const auto* it = std::lower_bound(begin, end, std::tuple{static_cast<uint32_t>(kind), name}, [this](const SBundleIndexEntry& entry, const auto& key) {
+        return std::tuple{entry.kind, nameOf(m_data, entry)} < key;
+    });
+
+    if (it == end || it->kind != kind || nameOf(m_data, *it) != name)
+        return nullptr;
+    return it;
+}
+
+std::string_view CBundle::module(std::string_view name) const {
+    const auto* entry = findEntry(BUNDLE_MODULE, name);
+    return entry ? std::string_view{reinterpret_cast<const char*>(m_data + entry->dataOffset), entry->dataSize} : std::string_view{};
+}
+
+std::string_view CBundle::asset(std::string_view name) const {
+    const auto* entry = findEntry(BUNDLE_ASSET, name);
+    return entry ? std::string_view{reinterpret_cast<const char*>(m_data + entry->dataOffset), entry->dataSize} : std::string_view{};
+}
+
+bool CBundle::hasAsset(std::string_view name) const {
+    return findEntry(BUNDLE_ASSET, name) != nullptr;
+}
+
+std::vector<std::string_view> CBundle::names(eBundleEntryKind kind) const {
+    const auto*                   header = reinterpret_cast<const SBundleHeader*>(m_data);
+    const auto*                   index  = indexOf(m_data);
+    std::vector<std::string_view> result;
+    for (uint32_t i = 0; i < header->count; ++i) {
+        if (index[i].kind == kind)
+            result.push_back(nameOf(m_data, index[i]));
+    }
+    return result;
+}
+
+std::string_view CBundle::entry() const {
+    const auto* header = reinterpret_cast<const SBundleHeader*>(m_data);
+    if (header->entry == NO_ENTRY)
+        return {};
+    return nameOf(m_data, indexOf(m_data)[header->entry]);
+}
+
+std::string CBundle::assetPath(std::string_view name) {
+    const std::string key(name);
+    if (auto it = m_assetFiles.find(key); it != m_assetFiles.end())
+        return it->second;
+
+    if (!hasAsset(name))
+        return "";
+
+    const std::string base = std::filesystem::path(key).filename().string();
+    const std::string file = runtimeDir() + "/hyprtoolkit-lua-bundle-" + std::to_string(getpid()) + "-" + std::to_string(m_assetFiles.size()) + "-" + base;
+
+    if (!writeRuntimeFile(file, asset(name)))
+        return "";
+
+    m_assetFiles.emplace(key, file);
+    return file;
+}
+
+const std::string& CBundle::path() const {
+    return m_path;
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,223 @@
+#include <hyprtoolkit-lua/ErrorLog.hpp>
+
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <thread>
+
+namespace Hyprtoolkit::Lua {
+
+using Clock = std::chrono::steady_clock;
+
+// Serializes writers so flush() and the flusher thread keep lines in order
+static std::mutex writeMutex;
+
+static void writeAll(const std::string& data) {
+    size_t done = 0;
+    while (done < data.size()) {
+        const auto n = ::write(STDERR_FILENO, data.data() + done, data.size() - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return;
+        done += n;
+    }
+}
+
+// repeats: occurrences folded into this line; shown: whether an earlier line was written
+static std::string formatLine(const SErrorRecord& record, uint64_t repeats, bool shown) {
+    std::string line = "[Lua] " + record.source + " error: " + record.message;
+    if (repeats && shown)
+        line += " (repeated " + std::to_string(repeats) + " more times)";
+    else if (repeats > 1)
+        line += " (" + std::to_string(repeats) + " times)";
+    line += '\n';
+    return line;
+}
+
+// Leaked on purpose, the flusher thread runs until exit
+CErrorLog& CErrorLog::get() {
+    static auto* log = [] {
+        auto* log = new CErrorLog();
+        std::atexit([]() { CErrorLog::get().flush(); });
+        return log;
+    }();
+    return *log;
+}
+
+CErrorLog::CErrorLog() : m_refilled(Clock::now()) {
+    m_entries.reserve(CAPACITY);
+}
+
+void CErrorLog::write(std::string line) {
+    if (m_buffer.size() + line.size() > MAX_BUFFER) {
+        ++m_stats.dropped;
+        return;
+    }
+    m_buffer += line;
+    ++m_stats.written;
+}
+
+bool CErrorLog::takeToken(Clock::time_point now) {
+    const std::chrono::duration<double> elapsed = now - m_refilled;
+    m_refilled                                  = now;
+    m_tokens                                    = std::min<double>(m_linesPerSecond, m_tokens + elapsed.count() * m_linesPerSecond);
+    if (m_tokens < 1)
+        return false;
+    m_tokens -= 1;
+    return true;
+}
+
+void CErrorLog::summarize(SEntry& entry, Clock::time_point now) {
+    if (!entry.pending)
+        return;
+    write(formatLine(entry.record, entry.pending, entry.shown));
+    entry.shown       = true;
+    entry.pending     = 0;
+    entry.windowStart = now;
+}
+
+void CErrorLog::summarizeExpired(Clock::time_point now) {
+    for (auto& entry : m_entries) {
+        if (entry.pending && now - entry.windowStart >= m_window)
+            summarize(entry, now);
+    }
+}
+
+void CErrorLog::report(std::string_view source, std::string_view message) {
+    const auto  now = Clock::now();
+    std::string key;
+    key.reserve(source.size() + message.size() + 1);
+    key.append(source).append(1, '\0').append(message);
+
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_stats.reported;
+
+        SEntry* entry = nullptr;
+        if (auto it = m_index.find(key); it != m_index.end()) {
+            entry = &m_entries[it->second];
+            ++entry->record.count;
+            entry->record.last = now;
+
+            // A repeat within the window is only counted
+            if (now - entry->windowStart < m_window) {
+                ++entry->pending;
+                ++m_stats.suppressed;
+                return;
+            }
+            summarize(*entry, now);
+        } else {
+            // New error: take a free slot, or the one after the last taken
+            size_t slot = m_entries.size();
+            if (slot < CAPACITY)
+                m_entries.emplace_back();
+            else {
+                // Write out the evicted error's pending repeats before its slot is reused
+                slot = m_next;
+                summarize(m_entries[slot], now);
+                m_index.erase(m_entries[slot].key);
+                m_entries[slot] = SEntry{};
+            }
+            m_next = (slot + 1) % CAPACITY;
+
+            entry                 = &m_entries[slot];
+            entry->record.source  = std::string(source);
+            entry->record.message = std::string(message);
+            entry->record.count   = 1;
+            entry->record.first   = now;
+            entry->record.last    = now;
+            entry->key            = std::move(key);
+            m_index.emplace(entry->key, slot);
+        }
+
+        entry->windowStart = now;
+        if (takeToken(now)) {
+            write(formatLine(entry->record, 0, false));
+            entry->shown = true;
+        } else {
+            ++entry->pending;
+            ++m_stats.suppressed;
+        }
+
+        if (!m_flusherStarted) {
+            m_flusherStarted = true;
+            std::thread([this]() { run(); }).detach();
+        }
+    }
+    m_cv.notify_one();
+}
+
+void CErrorLog::run() {
+    while (true) {
+        {
+            // Wakes for new output, and once per window to summarize repeats
+            std::unique_lock lock(m_mutex);
+            m_cv.wait_for(lock, m_window, [this]() { return !m_buffer.empty(); });
+        }
+
+        std::lock_guard writer(writeMutex);
+        std::string     out;
+        {
+            std::lock_guard lock(m_mutex);
+            summarizeExpired(Clock::now());
+            out.swap(m_buffer);
+        }
+        writeAll(out);
+    }
+}
+
+void CErrorLog::flush() {
+    std::lock_guard writer(writeMutex);
+    std::string     out;
+    {
+        std::lock_guard lock(m_mutex);
+        const auto      now = Clock::now();
+        for (auto& entry : m_entries) {
+            summarize(entry, now);
+        }
+        out.swap(m_buffer);
+    }
+    writeAll(out);
+}
+
+std::vector<SErrorRecord> CErrorLog::recent(size_t max) const {
+    std::vector<SErrorRecord> records;
+    {
+        std::lock_guard lock(m_mutex);
+        records.reserve(m_entries.size());
+        for (const auto& entry : m_entries) {
+            records.push_back(entry.record);
+        }
+    }
+
+    std::ranges::sort(records, [](const auto& a, const auto& b) { return a.last > b.last; });
+    if (records.size() > max)
+        records.resize(max);
+    return records;
+}
+
+SErrorLogStats CErrorLog::stats() const {
+    std::lock_guard lock(m_mutex);
+    auto            stats = m_stats;
+    stats.unique          = m_entries.size();
+    return stats;
+}
+
+void CErrorLog::clear() {
+    std::lock_guard lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+    m_next = 0;
+}
+
+void CErrorLog::setLimits(std::chrono::milliseconds window, size_t linesPerSecond) {
+    // A zero window would make the flusher's timed wait return immediately, forever
+    std::lock_guard lock(m_mutex);
+    m_window         = std::max(window, std::chrono::milliseconds(1));
+    m_linesPerSecond = std::max<size_t>(linesPerSecond, 1);
+    m_tokens         = std::min<double>(m_tokens, m_linesPerSecond);
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,177 @@
+#include <hyprtoolkit-lua/LuaAllocator.hpp>
+
+#include <sol/sol.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace Hyprtoolkit::Lua {
+
+// Block sizes are multiples of 16 so every block keeps malloc-like alignment
+static constexpr std::array<size_t, 16> SIZE_CLASSES = {16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512};
+
+CLuaAllocator::CLuaAllocator(bool pooled, size_t limit) : m_pooled(pooled), m_limit(limit) {
+    if (!m_pooled)
+        return;
+
+    m_pools.reserve(SIZE_CLASSES.size());
+    for (const auto size : SIZE_CLASSES) {
+        m_pools.emplace_back(SPool{.size = size});
+    }
+
+    // Map every 16-byte step up to MAX_POOLED to the smallest class that fits it
+    size_t cls = 0;
+    for (size_t step = 0; step < m_classForSize.size(); ++step) {
+        while (SIZE_CLASSES[cls] < step * 16)
+            ++cls;
+        m_classForSize[step] = static_cast<int>(cls);
+    }
+}
+
+CLuaAllocator::~CLuaAllocator() {
+    for (auto* arena : m_arenas) {
+        std::free(arena);
+    }
+}
+
+void* CLuaAllocator::alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+    auto* self = static_cast<CLuaAllocator*>(ud);
+
+    if (nsize == 0) {
+        if (ptr)
+            self->release(ptr, osize);
+        return nullptr;
+    }
+
+    // When ptr is null, osize encodes the object type rather than a size
+    const size_t oldSize = ptr ? osize : 0;
+
+    if (self->m_limit && nsize > oldSize && self->m_inUse - oldSize + nsize > self->m_limit) {
+        self->m_failed++;
+        return nullptr;
+    }
+
+    void* result = ptr ? self->reallocate(ptr, osize, nsize) : self->allocate(nsize);
+    if (!result) {
+        self->m_failed++;
+        return nullptr;
+    }
+
+    self->m_inUse = self->m_inUse - oldSize + nsize;
+    self->m_peak  = std::max(self->m_peak, self->m_inUse);
+    return result;
+}
+
+CLuaAllocator* CLuaAllocator::fromState(lua_State* L) {
+    void*      ud = nullptr;
+    const auto fn = lua_getallocf(L, &ud);
+    return fn == &CLuaAllocator::alloc ? static_cast<CLuaAllocator*>(ud) : nullptr;
+}
+
+int CLuaAllocator::poolIndex(size_t size) const {
+    if (!m_pooled || size > MAX_POOLED)
+        return -1;
+    return m_classForSize[(size + 15) / 16];
+}
+
+void* CLuaAllocator::allocate(size_t size) {
+    const int idx = poolIndex(size);
+    if (idx < 0) {
+        void* ptr = std::malloc(size);
+        if (ptr)
+            m_large += size;
+        return ptr;
+    }
+
+    auto& pool = m_pools[idx];
+
+    if (pool.freeList) {
+        auto* block   = pool.freeList;
+        pool.freeList = block->next;
+        pool.free--;
+        pool.inUse++;
+        return block;
+    }
+
+    if (!pool.bump || pool.bump + pool.size > pool.bumpEnd) {
+        auto* arena = static_cast<char*>(std::malloc(ARENA_SIZE));
+        if (!arena)
+            return nullptr;
+        m_arenas.push_back(arena);
+        pool.bump    = arena;
+        pool.bumpEnd = arena + ARENA_SIZE;
+    }
+
+    void* block = pool.bump;
+    pool.bump += pool.size;
+    pool.inUse++;
+    return block;
+}
+
+void CLuaAllocator::release(void* ptr, size_t size) {
+    m_inUse -= size;
+
+    const int idx = poolIndex(size);
+    if (idx < 0) {
+        m_large -= size;
+        std::free(ptr);
+        return;
+    }
+
+    auto& pool    = m_pools[idx];
+    auto* block   = static_cast<SFreeBlock*>(ptr);
+    block->next   = pool.freeList;
+    pool.freeList = block;
+    pool.inUse--;
+    pool.free++;
+}
+
+void* CLuaAllocator::reallocate(void* ptr, size_t osize, size_t nsize) {
+    const int oldIdx = poolIndex(osize);
+    const int newIdx = poolIndex(nsize);
+
+    // Same size class: the block already fits
+    if (oldIdx >= 0 && oldIdx == newIdx)
+        return ptr;
+
+    if (oldIdx < 0 && newIdx < 0) {
+        void* result = std::realloc(ptr, nsize);
+        if (result)
+            m_large = m_large - osize + nsize;
+        return result;
+    }
+
+    void* result = allocate(nsize);
+    if (!result)
+        return nullptr;
+
+    std::memcpy(result, ptr, std::min(osize, nsize));
+
+    // release() also updates m_inUse, which alloc() accounts for on its own
+    m_inUse += osize;
+    release(ptr, osize);
+    return result;
+}
+
+SLuaAllocatorStats CLuaAllocator::stats() const {
+    SLuaAllocatorStats stats{
+        .bytesInUse        = m_inUse,
+        .peakBytes         = m_peak,
+        .limit             = m_limit,
+        .arenaBytes        = m_arenas.size() * ARENA_SIZE,
+        .largeBytes        = m_large,
+        .failedAllocations = m_failed,
+    };
+
+    for (const auto& pool : m_pools) {
+        stats.sizeClasses.push_back({.size = pool.size, .inUse = pool.inUse, .free = pool.free});
+    }
+
+    return stats;
+}
+
+void CLuaAllocator::setLimit(size_t limit) {
+    m_limit = limit;
+}
+
+} // namespace Hyprtoolkit::Lua
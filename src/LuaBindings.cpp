@@ -1,5 +1,6 @@
 #include <hyprtoolkit-lua/LuaBindings.hpp>
 #include <hyprtoolkit-lua/LuaState.hpp>
+#include <hyprtoolkit-lua/StartupTimings.hpp>
 
 #include "helpers/SmartPtrAdapter.hpp"
 #include "helpers/CallbackAdapter.hpp"
@@ -11,24 +12,124 @@ namespace Hyprtoolkit::Lua {
 
 void registerAllBindings(sol::state& lua) {
     // 1. Basic types first (Vector2D, CBox, CHyprColor, etc.)
-    registerTypes(lua);
+    {
+        CStartupTimings::CScope phase("registerTypes");
+        registerTypes(lua);
+    }
 
     // 2. Core types (Backend, Timer, Output, Icons)
-    registerCore(lua);
+    {
+        CStartupTimings::CScope phase("registerCore");
+        registerCore(lua);
+    }
 
     // 3. Base element (IElement)
-    registerElement(lua);
+    {
+        CStartupTimings::CScope phase("registerElement");
+        registerElement(lua);
+    }
 
     // 4. All element builders and instances
-    registerElementBuilders(lua);
+    {
+        CStartupTimings::CScope phase("registerElementBuilders");
+        registerElementBuilders(lua);
+    }
 
     // 5. Window (depends on IElement)
-    registerWindow(lua);
+    {
+        CStartupTimings::CScope phase("registerWindow");
+        registerWindow(lua);
+    }
+
+    // 6. Reference and heap accounting
+    {
+        CStartupTimings::CScope phase("registerInstrumentation");
+        registerInstrumentation(lua);
+    }
+
+    // 7. Callback budget violations
+    {
+        CStartupTimings::CScope phase("registerWatchdog");
+        registerWatchdog(lua);
+    }
+
+    // 8. Tweens and color cells (extends IBackend)
+    {
+        CStartupTimings::CScope phase("registerAnimation");
+        registerAnimation(lua);
+    }
+
+    // 9. Async file I/O
+    {
+        CStartupTimings::CScope phase("registerFs");
+        registerFs(lua);
+    }
+
+    // 10. Subprocesses
+    {
+        CStartupTimings::CScope phase("registerProcess");
+        registerProcess(lua);
+    }
+
+    // 11. Trace export
+    {
+        CStartupTimings::CScope phase("registerTrace");
+        registerTrace(lua);
+    }
+
+    // 12. Image buffers (extends CImageBuilder)
+    {
+        CStartupTimings::CScope phase("registerImageOps");
+        registerImageOps(lua);
+    }
+
+    // 13. Time-sliced coroutine tasks
+    {
+        CStartupTimings::CScope phase("registerTasks");
+        registerTasks(lua);
+    }
+
+    // 14. Script bundle assets
+    {
+        CStartupTimings::CScope phase("registerBundle");
+        registerBundle(lua);
+    }
+
+    // 15. Keyed reconciler (element types are registered by registerElementBuilders)
+    {
+        CStartupTimings::CScope phase("registerReconciler");
+        registerReconciler(lua);
+    }
+
+    // 16. Host events posted from other threads
+    {
+        CStartupTimings::CScope phase("registerEvents");
+        registerEvents(lua);
+    }
+
+    // 17. Piece-table documents for textboxes in delta mode
+    {
+        CStartupTimings::CScope phase("registerTextDocument");
+        registerTextDocument(lua);
+    }
+
+    // 18. Binding error log
+    {
+        CStartupTimings::CScope phase("registerErrors");
+        registerErrors(lua);
+    }
 }
 
 CSharedPointer<CLuaState> createLuaState() {
-    auto state = makeShared<CLuaState>();
-    state->openLibs();
+    return createLuaState(SLuaStateOptions{});
+}
+
+CSharedPointer<CLuaState> createLuaState(const SLuaStateOptions& options) {
+    auto state = makeShared<CLuaState>(options);
+    {
+        CStartupTimings::CScope phase("openLibs");
+        state->openLibs();
+    }
     registerAllBindings(state->lua());
     return state;
 }
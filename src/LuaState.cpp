@@ -1,10 +1,36 @@
 #include <hyprtoolkit-lua/LuaState.hpp>
+#include <hyprtoolkit-lua/StartupTimings.hpp>
+
+#include "helpers/Async.hpp"
+#include "helpers/EventQueue.hpp"
+
+#ifdef HYPRTOOLKIT_LUA_LUAJIT
+#include "helpers/LuaJITCompat.hpp"
+#endif
 
 namespace Hyprtoolkit::Lua {
 
-CLuaState::CLuaState() = default;
+static std::unique_ptr<CLuaAllocator> makeAllocator(const SLuaStateOptions& options) {
+    if (!options.pooledAllocator && !options.memoryLimit)
+        return nullptr;
+    return std::make_unique<CLuaAllocator>(options.pooledAllocator, options.memoryLimit);
+}
 
-CLuaState::~CLuaState() = default;
+CLuaState::CLuaState() : CLuaState(SLuaStateOptions{}) {}
+
+CLuaState::CLuaState(const SLuaStateOptions& options) :
+    m_allocator(makeAllocator(options)), m_lua(m_allocator ? sol::state(sol::default_at_panic, &CLuaAllocator::alloc, m_allocator.get()) : sol::state()),
+    m_events(std::make_shared<CEventQueue>(m_lua.lua_state())) {}
+
+CLuaState::~CLuaState() {
+    // Handles may outlive the state, leave them holding nothing
+    for (const auto& [name, slot] : m_slots) {
+        slot->state = nullptr;
+        slot->fn    = sol::protected_function();
+        slot->value = sol::object();
+        slot->key   = sol::object();
+    }
+}
 
 sol::state& CLuaState::lua() {
     return m_lua;
@@ -16,10 +42,33 @@ const sol::state& CLuaState::lua() const {
 
 void CLuaState::openLibs() {
     m_lua.open_libraries(sol::lib::base, sol::lib::package, sol::lib::coroutine, sol::lib::string, sol::lib::os, sol::lib::math, sol::lib::table, sol::lib::io);
+
+#ifdef HYPRTOOLKIT_LUA_LUAJIT
+    // bit and jit are LuaJIT's own, the prelude fills in the 5.4 library functions
+    m_lua.open_libraries(sol::lib::bit32, sol::lib::jit);
+    m_lua.safe_script(LUAJIT_COMPAT_PRELUDE, sol::script_pass_on_error, "=luajit-compat");
+#endif
 }
 
 sol::protected_function_result CLuaState::doFile(const std::string& path) {
-    return m_lua.safe_script_file(path, sol::script_pass_on_error);
+    // "script" normally ends when the script enters the backend loop
+    CStartupTimings::CScope phase("script");
+    if (!CBundle::isBundle(path))
+        return m_lua.safe_script_file(path, sol::script_pass_on_error);
+
+    std::string error;
+    auto        bundle = CBundle::open(path, error);
+    if (!bundle) {
+        sol::protected_function fail = m_lua["error"];
+        return fail(error, 0);
+    }
+
+    m_bundle = std::move(bundle);
+    m_bundle->mount(m_lua.lua_state());
+
+    // The entry script is required like any module, so it is found by the same searcher
+    sol::protected_function require = m_lua["require"];
+    return require(std::string(m_bundle->entry()));
 }
 
 sol::protected_function_result CLuaState::doString(const std::string& code) {
@@ -30,4 +79,76 @@ bool CLuaState::has(const std::string& name) const {
     return m_lua[name].valid();
 }
 
+void CLuaState::post(std::string event, LuaEventPayload payload) {
+    if (m_events)
+        m_events->push(std::move(event), std::move(payload));
+}
+
+void CLuaState::attachBackend(const Hyprutils::Memory::CSharedPointer<IBackend>& backend) {
+    CMainQueue::get().attach(backend);
+}
+
+static void assignSlot(SLuaGlobalSlot& slot, const sol::object& value) {
+    slot.value = value;
+    slot.fn    = value.get_type() == sol::type::function ? value.as<sol::protected_function>() : sol::protected_function();
+    ++slot.generation;
+}
+
+bool syncLuaGlobalSlot(SLuaGlobalSlot& slot) {
+    lua_State* L = slot.state;
+    if (!L)
+        return false;
+
+    // Raw reads only, no metamethod runs on the hot path
+    const int top = lua_gettop(L);
+    lua_pushglobaltable(L);
+    slot.key.push(L);
+    lua_rawget(L, -2);
+    slot.value.push(L);
+    if (!lua_rawequal(L, -1, -2))
+        assignSlot(slot, sol::object(L, -2));
+    lua_settop(L, top);
+    return true;
+}
+
+std::shared_ptr<SLuaGlobalSlot> CLuaState::bindSlot(const std::string& name) {
+    if (auto it = m_slots.find(name); it != m_slots.end())
+        return it->second;
+
+    auto slot       = std::make_shared<SLuaGlobalSlot>();
+    slot->name      = name;
+    slot->traceName = CTracer::get().intern(name);
+    slot->state     = m_lua.lua_state();
+    slot->key       = sol::make_object(m_lua, name);
+    assignSlot(*slot, m_lua.globals().raw_get<sol::object>(name));
+    slot->generation = 0;
+
+    m_slots.emplace(name, slot);
+    return slot;
+}
+
+std::optional<SLuaAllocatorStats> CLuaState::allocatorStats() const {
+    if (!m_allocator)
+        return std::nullopt;
+    return m_allocator->stats();
+}
+
+void CLuaState::enableWatchdog(const SWatchdogOptions& options) {
+    // Only one count hook per state, drop the old one first
+    m_watchdog.reset();
+    m_watchdog = std::make_unique<CWatchdog>(m_lua.lua_state(), options);
+}
+
+void CLuaState::disableWatchdog() {
+    m_watchdog.reset();
+}
+
+CWatchdog* CLuaState::watchdog() const {
+    return m_watchdog.get();
+}
+
+CBundle* CLuaState::bundle() const {
+    return m_bundle.get();
+}
+
 } // namespace Hyprtoolkit::Lua
@@ -0,0 +1,93 @@
+#include <hyprtoolkit-lua/StartupTimings.hpp>
+
+#include <cstdio>
+
+namespace Hyprtoolkit::Lua {
+
+CStartupTimings& CStartupTimings::get() {
+    static CStartupTimings timings;
+    return timings;
+}
+
+CStartupTimings::CStartupTimings() : m_origin(std::chrono::steady_clock::now()) {}
+
+CStartupTimings::CScope::CScope(const char* name) : m_name(name) {
+    CStartupTimings::get().startPhase(m_name);
+}
+
+CStartupTimings::CScope::~CScope() {
+    CStartupTimings::get().endPhase(m_name);
+}
+
+void CStartupTimings::startPhase(const std::string& name) {
+    if (m_finished)
+        return;
+
+    // Only the first occurrence of a phase counts
+    for (const auto& phase : m_phases) {
+        if (phase.name == name)
+            return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    m_phases.push_back(SStartupPhase{
+        .name  = name,
+        .start = std::chrono::duration_cast<std::chrono::microseconds>(now - m_origin),
+    });
+}
+
+void CStartupTimings::endPhase(const std::string& name) {
+    for (auto& phase : m_phases) {
+        if (phase.name != name || !phase.open)
+            continue;
+
+        auto now       = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_origin);
+        phase.duration = now - phase.start;
+        phase.open     = false;
+        return;
+    }
+}
+
+void CStartupTimings::finish() {
+    if (m_finished)
+        return;
+
+    m_finished = true;
+    if (m_onFinished)
+        m_onFinished();
+}
+
+bool CStartupTimings::finished() const {
+    return m_finished;
+}
+
+void CStartupTimings::onFinished(std::function<void()> callback) {
+    m_onFinished = std::move(callback);
+}
+
+void CStartupTimings::restart() {
+    m_origin   = std::chrono::steady_clock::now();
+    m_finished = false;
+    m_phases.clear();
+}
+
+const std::vector<SStartupPhase>& CStartupTimings::phases() const {
+    return m_phases;
+}
+
+std::string CStartupTimings::format() const {
+    std::string out;
+    char        line[160];
+
+    for (const auto& phase : m_phases) {
+        if (phase.open)
+            snprintf(line, sizeof(line), "  %-28s %10.3f ms  (unfinished)\n", phase.name.c_str(), phase.start.count() / 1000.0);
+        else
+            snprintf(line, sizeof(line), "  %-28s %10.3f ms  +%.3f ms\n", phase.name.c_str(), phase.start.count() / 1000.0, phase.duration.count() / 1000.0);
+        out += line;
+    }
+
+    return out;
+}
+
+} // namespace Hyprtoolkit::Lua
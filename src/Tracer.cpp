@@ -0,0 +1,234 @@
+#include <hyprtoolkit-lua/Tracer.hpp>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <unordered_set>
+
+namespace Hyprtoolkit::Lua {
+
+static uint32_t currentTid() {
+    thread_local const uint32_t tid = static_cast<uint32_t>(syscall(SYS_gettid));
+    return tid;
+}
+
+static void appendEscaped(std::string& out, const char* str) {
+    for (const char* c = str; *c; ++c) {
+        switch (*c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(*c) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", *c);
+                    out += buf;
+                } else
+                    out += *c;
+        }
+    }
+}
+
+CTracer& CTracer::get() {
+    static CTracer tracer;
+    return tracer;
+}
+
+CTracer::CTracer() : m_origin(std::chrono::steady_clock::now()) {}
+
+// Only call from the thread that runs the loop. A new capacity swaps in a new buffer;
+// the old one stays allocated, so a worker still inside record() writes into it safely.
+void CTracer::enable(size_t capacity) {
+    // Round up to a power of two so the ring index is a mask
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+
+    const auto* current = m_buffer.load(std::memory_order_relaxed);
+    if (!current || rounded != current->capacity) {
+        auto buffer      = std::make_unique<SBuffer>();
+        buffer->events   = std::make_unique<SEvent[]>(rounded);
+        buffer->capacity = rounded;
+        m_buffer.store(buffer.get(), std::memory_order_release);
+        m_buffers.emplace_back(std::move(buffer));
+    }
+
+    m_enabled.store(true, std::memory_order_release);
+}
+
+void CTracer::disable() {
+    m_enabled.store(false, std::memory_order_release);
+}
+
+CTracer::CSpan::CSpan(const char* name, const char* category, const char* detail) {
+    if (!CTracer::get().enabled())
+        return;
+
+    m_name     = name;
+    m_category = category;
+    m_detail   = detail;
+    m_start    = std::chrono::steady_clock::now();
+}
+
+CTracer::CSpan::~CSpan() {
+    auto& tracer = CTracer::get();
+    if (!m_name || !tracer.enabled())
+        return;
+
+    const auto start = tracer.sinceOrigin(m_start);
+    tracer.record('X', m_name, m_category, m_detail, start, tracer.now() - start, 0);
+}
+
+void CTracer::instant(const char* name, const char* category, const char* detail) {
+    if (enabled())
+        record('i', name, category, detail, now(), 0, 0);
+}
+
+void CTracer::counter(const char* name, const char* category, double value) {
+    if (enabled())
+        record('C', name, category, nullptr, now(), 0, value);
+}
+
+const char* CTracer::intern(const std::string& str) {
+    static std::mutex                      mutex;
+    static std::unordered_set<std::string> strings;
+
+    std::lock_guard                        lock(mutex);
+    return strings.insert(str).first->c_str();
+}
+
+void CTracer::record(char phase, const char* name, const char* category, const char* detail, uint64_t ts, uint64_t dur, double value) {
+    auto* buffer = m_buffer.load(std::memory_order_acquire);
+    if (!buffer)
+        return;
+
+    const uint64_t index = buffer->head.fetch_add(1, std::memory_order_relaxed);
+    auto&          event = buffer->events[index & (buffer->capacity - 1)];
+
+    // Invalidate the slot while it's being rewritten
+    event.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name     = name;
+    event.category = category;
+    event.detail   = detail;
+    event.ts       = ts;
+    event.dur      = dur;
+    event.value    = value;
+    event.tid      = currentTid();
+    event.phase    = phase;
+    event.seq.store(index + 1, std::memory_order_release);
+}
+
+uint64_t CTracer::now() const {
+    return sinceOrigin(std::chrono::steady_clock::now());
+}
+
+uint64_t CTracer::sinceOrigin(std::chrono::steady_clock::time_point tp) const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(tp - m_origin).count();
+}
+
+size_t CTracer::size() const {
+    const auto* buffer = m_buffer.load(std::memory_order_acquire);
+    return buffer ? std::min<uint64_t>(buffer->head.load(std::memory_order_acquire), buffer->capacity) : 0;
+}
+
+uint64_t CTracer::dropped() const {
+    const auto* buffer = m_buffer.load(std::memory_order_acquire);
+    if (!buffer)
+        return 0;
+
+    const auto head = buffer->head.load(std::memory_order_acquire);
+    return head > buffer->capacity ? head - buffer->capacity : 0;
+}
+
+void CTracer::clear() {
+    auto* buffer = m_buffer.load(std::memory_order_acquire);
+    if (!buffer)
+        return;
+
+    buffer->head.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < buffer->capacity; ++i) {
+        buffer->events[i].seq.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::string CTracer::json() const {
+    std::string out    = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    const auto  pid    = getpid();
+    const auto* buffer = m_buffer.load(std::memory_order_acquire);
+    const auto  end    = buffer ? buffer->head.load(std::memory_order_acquire) : 0;
+    const auto  mask   = buffer ? buffer->capacity - 1 : 0;
+    bool        first  = true;
+    char        buf[160];
+
+    for (uint64_t index = end > mask + 1 ? end - mask - 1 : 0; index < end; ++index) {
+        const auto& slot = buffer->events[index & mask];
+
+        // Skip slots that are mid-write or were already overwritten, checked again after
+        // the copy in case a writer started on the slot while it was being read
+        if (slot.seq.load(std::memory_order_acquire) != index + 1)
+            continue;
+
+        struct {
+            const char* name;
+            const char* category;
+            const char* detail;
+            uint64_t    ts, dur;
+            double      value;
+            uint32_t    tid;
+            char        phase;
+        } event = {slot.name, slot.category, slot.detail, slot.ts, slot.dur, slot.value, slot.tid, slot.phase};
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != index + 1)
+            continue;
+
+        out += first ? "\n" : ",\n";
+        first = false;
+
+        out += "{\"name\":\"";
+        appendEscaped(out, event.name);
+        out += "\",\"cat\":\"";
+        appendEscaped(out, event.category ? event.category : "");
+
+        snprintf(buf, sizeof(buf), "\",\"ph\":\"%c\",\"ts\":%" PRIu64 ",\"pid\":%d,\"tid\":%u", event.phase, event.ts, pid, event.tid);
+        out += buf;
+
+        if (event.phase == 'X') {
+            snprintf(buf, sizeof(buf), ",\"dur\":%" PRIu64, event.dur);
+            out += buf;
+        } else if (event.phase == 'i')
+            out += ",\"s\":\"t\"";
+
+        if (event.phase == 'C') {
+            snprintf(buf, sizeof(buf), ",\"args\":{\"value\":%.3f}", event.value);
+            out += buf;
+        } else if (event.detail) {
+            out += ",\"args\":{\"detail\":\"";
+            appendEscaped(out, event.detail);
+            out += "\"}";
+        }
+
+        out += "}";
+    }
+
+    out += "\n]}\n";
+    return out;
+}
+
+bool CTracer::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+    file << json();
+    return file.good();
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,155 @@
+#include <hyprtoolkit-lua/Watchdog.hpp>
+
+#include <sol/sol.hpp>
+#include <algorithm>
+#include <cstdio>
+
+#ifdef HYPRTOOLKIT_LUA_LUAJIT
+#include <luajit.h>
+#endif
+
+namespace Hyprtoolkit::Lua {
+
+// Address used as the registry key for the installed watchdog
+static const char WATCHDOG_KEY = 0;
+
+// Keep the newest violations only, a broken timer would otherwise grow this forever
+static constexpr size_t MAX_VIOLATIONS = 256;
+
+// Armed watchdog on this thread, read by the hook
+static thread_local CWatchdog* s_armed = nullptr;
+
+CWatchdog::CWatchdog(lua_State* L, const SWatchdogOptions& options) : m_state(sol::main_thread(L, L)), m_options(options) {
+    lua_pushlightuserdata(m_state, this);
+    lua_rawsetp(m_state, LUA_REGISTRYINDEX, &WATCHDOG_KEY);
+    lua_sethook(m_state, &CWatchdog::hook, LUA_MASKCOUNT, std::max(m_options.checkInterval, 1));
+
+#ifdef HYPRTOOLKIT_LUA_LUAJIT
+    // Count hooks never fire inside compiled traces, so `while true do end` would run
+    // forever. The JIT stays off, and already compiled code is dropped, while a
+    // watchdog is installed.
+    luaJIT_setmode(m_state, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_FLUSH);
+    luaJIT_setmode(m_state, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_OFF);
+#endif
+}
+
+CWatchdog::~CWatchdog() {
+#ifdef HYPRTOOLKIT_LUA_LUAJIT
+    luaJIT_setmode(m_state, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_ON);
+#endif
+    lua_sethook(m_state, nullptr, 0, 0);
+    lua_pushnil(m_state);
+    lua_rawsetp(m_state, LUA_REGISTRYINDEX, &WATCHDOG_KEY);
+
+    if (s_armed == this)
+        s_armed = nullptr;
+}
+
+CWatchdog* CWatchdog::fromState(lua_State* L) {
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &WATCHDOG_KEY);
+    auto* watchdog = static_cast<CWatchdog*>(lua_touserdata(L, -1));
+    lua_pop(L, 1);
+    return watchdog;
+}
+
+CWatchdog::CScope::CScope(lua_State* L, const char* what, const char* detail) {
+    m_watchdog = fromState(L);
+    if (!m_watchdog)
+        return;
+
+    if (m_watchdog->m_depth++ > 0)
+        return;
+
+    m_watchdog->m_tripped      = false;
+    m_watchdog->m_what         = what;
+    m_watchdog->m_detail       = detail;
+    m_watchdog->m_instructions = 0;
+    m_watchdog->m_start        = std::chrono::steady_clock::now();
+    s_armed                    = m_watchdog;
+}
+
+CWatchdog::CScope::~CScope() {
+    if (!m_watchdog)
+        return;
+
+    if (--m_watchdog->m_depth > 0)
+        return;
+
+    m_watchdog->m_what = nullptr;
+    if (s_armed == m_watchdog)
+        s_armed = nullptr;
+}
+
+const SWatchdogOptions& CWatchdog::options() const {
+    return m_options;
+}
+
+const std::vector<SWatchdogViolation>& CWatchdog::violations() const {
+    return m_violations;
+}
+
+void CWatchdog::clearViolations() {
+    m_violations.clear();
+}
+
+bool CWatchdog::overBudget() const {
+    if (m_options.instructionBudget && m_instructions > m_options.instructionBudget)
+        return true;
+
+    return m_options.timeBudget.count() > 0 && std::chrono::steady_clock::now() - m_start > m_options.timeBudget;
+}
+
+void CWatchdog::recordViolation(lua_State* L, lua_Debug* ar) {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start);
+
+    std::string callback = m_what ? m_what : "callback";
+    if (m_detail)
+        callback += std::string(".") + m_detail;
+
+    std::string source = "?";
+    if (lua_getinfo(L, "Sl", ar))
+        source = std::string(ar->short_src) + ":" + std::to_string(ar->currentline);
+
+    char msg[512];
+    snprintf(msg, sizeof(msg), "watchdog: %s exceeded its budget after %.1f ms (%llu instructions) at %s", callback.c_str(), elapsed.count() / 1000.0,
+             static_cast<unsigned long long>(m_instructions), source.c_str());
+
+    // Leaves the message with a traceback on the stack for the hook to raise
+    luaL_traceback(L, L, msg, 0);
+
+    if (m_violations.size() >= MAX_VIOLATIONS)
+        m_violations.erase(m_violations.begin());
+
+    m_violations.push_back(SWatchdogViolation{
+        .callback     = std::move(callback),
+        .source       = std::move(source),
+        .traceback    = lua_tostring(L, -1),
+        .elapsed      = elapsed,
+        .instructions = m_instructions,
+    });
+}
+
+void CWatchdog::hook(lua_State* L, lua_Debug* ar) {
+    auto* self = s_armed;
+    if (!self)
+        return;
+
+    // Once tripped, keep failing so a pcall inside the runaway loop can't swallow the abort
+    if (self->m_tripped) {
+        lua_pushstring(L, "watchdog: callback aborted");
+        lua_error(L);
+        return;
+    }
+
+    self->m_instructions += self->m_options.checkInterval;
+    if (!self->overBudget())
+        return;
+
+    self->m_tripped = true;
+    self->recordViolation(L, ar);
+
+    // No C++ objects with destructors may be alive here, lua_error does not return
+    lua_error(L);
+}
+
+} // namespace Hyprtoolkit::Lua
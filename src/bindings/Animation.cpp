@@ -0,0 +1,384 @@
+#include <sol/sol.hpp>
+#include <hyprtoolkit/core/Backend.hpp>
+#include <hyprtoolkit/core/Timer.hpp>
+#include <hyprtoolkit/core/Output.hpp>
+#include <hyprtoolkit/element/Element.hpp>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "../helpers/SmartPtrAdapter.hpp"
+#include "../helpers/CallbackAdapter.hpp"
+#include "../helpers/ColorCell.hpp"
+#include "../helpers/ElementAdapter.hpp"
+#include "../helpers/RefTracker.hpp"
+
+using namespace Hyprutils::Memory;
+using namespace Hyprutils::Math;
+
+namespace Hyprtoolkit::Lua {
+
+using easingFn = std::function<double(double)>;
+
+// Cubic bezier through (0,0), (x1,y1), (x2,y2), (1,1), like CSS cubic-bezier()
+static easingFn bezierEasing(double x1, double y1, double x2, double y2) {
+    return [=](double t) {
+        const auto coord = [](double a, double b, double s) {
+            const double inv = 1.0 - s;
+            return 3 * inv * inv * s * a + 3 * inv * s * s * b + s * s * s;
+        };
+        const auto slope = [](double a, double b, double s) {
+            const double inv = 1.0 - s;
+            return 3 * inv * inv * a + 6 * inv * s * (b - a) + 3 * s * s * (1.0 - b);
+        };
+
+        // Solve x(s) = t with Newton's method, fall back to bisection on flat slopes
+        double s = t;
+        for (int i = 0; i < 8; ++i) {
+            const double dx = coord(x1, x2, s) - t;
+            const double d  = slope(x1, x2, s);
+            if (std::abs(dx) < 1e-6)
+                return coord(y1, y2, s);
+            if (std::abs(d) < 1e-6)
+                break;
+            s -= dx / d;
+        }
+
+        double lo = 0.0, hi = 1.0;
+        s         = t;
+        for (int i = 0; i < 32 && hi - lo > 1e-6; ++i) {
+            if (coord(x1, x2, s) < t)
+                lo = s;
+            else
+                hi = s;
+            s = (lo + hi) / 2.0;
+        }
+        return coord(y1, y2, s);
+    };
+}
+
+static const std::unordered_map<std::string, easingFn>& namedEasings() {
+    static const std::unordered_map<std::string, easingFn> easings = {
+        {"linear", [](double t) { return t; }},
+        {"easeInQuad", [](double t) { return t * t; }},
+        {"easeOutQuad", [](double t) { return 1.0 - (1.0 - t) * (1.0 - t); }},
+        {"easeInOutQuad", [](double t) { return t < 0.5 ? 2 * t * t : 1.0 - std::pow(-2 * t + 2, 2) / 2; }},
+        {"easeInCubic", [](double t) { return t * t * t; }},
+        {"easeOutCubic", [](double t) { return 1.0 - std::pow(1.0 - t, 3); }},
+        {"easeInOutCubic", [](double t) { return t < 0.5 ? 4 * t * t * t : 1.0 - std::pow(-2 * t + 2, 3) / 2; }},
+        {"easeInOutSine", [](double t) { return -(std::cos(M_PI * t) - 1.0) / 2; }},
+        {"easeOutBack", [](double t) {
+             constexpr double C1 = 1.70158;
+             constexpr double C3 = C1 + 1;
+             return 1 + C3 * std::pow(t - 1, 3) + C1 * std::pow(t - 1, 2);
+         }},
+    };
+    return easings;
+}
+
+enum eTweenProperty : uint8_t {
+    TWEEN_MARGIN = 0,
+    TWEEN_POSITION,
+    TWEEN_COLOR,
+};
+
+// One running interpolation. Values are kept as up to four doubles so margin,
+// position and color share the same stepping code.
+class CTween {
+  public:
+    void cancel() {
+        m_cancelled = true;
+    }
+
+    bool active() const {
+        return !m_cancelled && !m_done;
+    }
+
+    double progress() const {
+        return m_progress;
+    }
+
+    eTweenProperty                            m_property = TWEEN_MARGIN;
+    CWeakPointer<IElement>                    m_element;
+    CSharedPointer<CColorCell>                m_cell;
+    std::vector<CWeakPointer<IElement>>       m_redraw;
+
+    std::array<double, 4>                     m_from = {};
+    std::array<double, 4>                     m_to   = {};
+    std::chrono::duration<double, std::milli> m_duration{0};
+    std::chrono::duration<double, std::milli> m_delay{0};
+    easingFn                                  m_easing;
+    int                                       m_repeat = 0; // extra runs, -1 forever
+    bool                                      m_yoyo   = false;
+    std::optional<CLuaFunctionRef>            m_onDone;
+
+    std::chrono::steady_clock::time_point     m_start;
+    double                                    m_progress  = 0.0;
+    bool                                      m_cancelled = false;
+    bool                                      m_done      = false;
+};
+
+// Steps every running tween from a single backend timer ticking at the frame rate
+// of the fastest output. Lua is only entered for onDone callbacks.
+class CAnimator {
+  public:
+    // Leaked like the async singletons: tweens hold onDone refs, which must not be
+    // released after the state is closed at exit
+    static CAnimator& get() {
+        static auto* animator = new CAnimator();
+        return *animator;
+    }
+
+    void add(CSharedPointer<IBackend> backend, CSharedPointer<CTween> tween) {
+        // A new tween takes over the property from one still running on it
+        for (auto& other : m_tweens) {
+            if (other->m_property != tween->m_property)
+                continue;
+            if (tween->m_cell ? other->m_cell == tween->m_cell : other->m_element.lock() == tween->m_element.lock())
+                other->cancel();
+        }
+
+        tween->m_start = std::chrono::steady_clock::now();
+        m_tweens.push_back(tween);
+
+        if (m_backend.lock() != backend) {
+            m_backend  = backend;
+            m_interval = frameInterval(backend);
+        }
+
+        schedule();
+    }
+
+    size_t active() const {
+        return m_tweens.size();
+    }
+
+  private:
+    static std::chrono::milliseconds frameInterval(const CSharedPointer<IBackend>& backend) {
+        uint32_t fps = 0;
+        for (const auto& output : backend->getOutputs()) {
+            fps = std::max<uint32_t>(fps, output->fps());
+        }
+        return std::chrono::milliseconds(std::max(1, static_cast<int>(1000 / (fps ? fps : 60))));
+    }
+
+    void schedule() {
+        auto backend = m_backend.lock();
+        // A tick pending on a backend that has since been destroyed never fires
+        if (!m_timerBackend.expired() || m_tweens.empty() || !backend)
+            return;
+
+        m_timerBackend = backend;
+        backend->addTimer(m_interval, [](CAtomicSharedPointer<CTimer>, void*) { CAnimator::get().tick(); }, nullptr, false);
+    }
+
+    void tick() {
+        m_timerBackend.reset();
+        const auto now = std::chrono::steady_clock::now();
+
+        std::vector<std::pair<CSharedPointer<CTween>, bool>> ended;
+
+        for (auto& tween : m_tweens) {
+            if (tween->m_cancelled || (!tween->m_cell && !tween->m_element.lock())) {
+                tween->m_cancelled = true;
+                ended.emplace_back(tween, false);
+                continue;
+            }
+
+            const auto elapsed = std::chrono::duration<double, std::milli>(now - tween->m_start) - tween->m_delay;
+            if (elapsed.count() < 0)
+                continue;
+
+            const double t    = tween->m_duration.count() > 0 ? std::min(1.0, elapsed / tween->m_duration) : 1.0;
+            tween->m_progress = t;
+            apply(*tween, tween->m_easing(t));
+
+            if (t < 1.0)
+                continue;
+
+            if (tween->m_repeat != 0) {
+                if (tween->m_repeat > 0)
+                    --tween->m_repeat;
+                if (tween->m_yoyo)
+                    std::swap(tween->m_from, tween->m_to);
+                tween->m_start = now;
+                tween->m_delay = {};
+                continue;
+            }
+
+            tween->m_done = true;
+            ended.emplace_back(tween, true);
+        }
+
+        std::erase_if(m_tweens, [](const auto& tween) { return !tween->active(); });
+
+        // onDone may start new tweens, so run it after the list is settled
+        for (const auto& [tween, completed] : ended) {
+            // Drop the reference either way, the function may hold the tween itself
+            auto onDone = std::move(tween->m_onDone);
+            tween->m_onDone.reset();
+            if (onDone)
+                invokeLuaCallback(*onDone, nullptr, completed);
+        }
+
+        schedule();
+    }
+
+    static void apply(CTween& tween, double eased) {
+        std::array<double, 4> v;
+        for (size_t i = 0; i < v.size(); ++i) {
+            v[i] = tween.m_from[i] + (tween.m_to[i] - tween.m_from[i]) * eased;
+        }
+
+        auto element = tween.m_element.lock();
+        switch (tween.m_property) {
+            case TWEEN_MARGIN: element->setMargin(static_cast<float>(v[0])); break;
+            case TWEEN_POSITION: element->setAbsolutePosition(Vector2D{v[0], v[1]}); break;
+            case TWEEN_COLOR: tween.m_cell->set(CHyprColor(v[0], v[1], v[2], v[3])); break;
+        }
+
+        if (element)
+            element->forceReposition();
+        for (const auto& weak : tween.m_redraw) {
+            if (auto redraw = weak.lock())
+                redraw->forceReposition();
+        }
+    }
+
+    CWeakPointer<IBackend>              m_backend;
+    CWeakPointer<IBackend>              m_timerBackend; // set while a tick is pending on it
+    std::chrono::milliseconds           m_interval{16};
+    std::vector<CSharedPointer<CTween>> m_tweens;
+};
+
+static std::array<double, 4> tweenValue(eTweenProperty property, const sol::object& obj) {
+    switch (property) {
+        case TWEEN_MARGIN: return {obj.as<double>(), 0, 0, 0};
+        case TWEEN_POSITION: {
+            if (obj.is<Vector2D>()) {
+                const auto v = obj.as<Vector2D>();
+                return {v.x, v.y, 0, 0};
+            }
+            sol::table pt = obj;
+            return {pt[1].get<double>(), pt[2].get<double>(), 0, 0};
+        }
+        case TWEEN_COLOR: {
+            const auto c = obj.as<CHyprColor>();
+            return {c.r, c.g, c.b, c.a};
+        }
+    }
+    return {};
+}
+
+static easingFn tweenEasing(const sol::object& obj) {
+    if (!obj.valid() || obj.is<sol::nil_t>())
+        return namedEasings().at("easeOutCubic");
+
+    if (obj.is<sol::table>()) {
+        sol::table curve = obj;
+        return bezierEasing(curve[1].get<double>(), curve[2].get<double>(), curve[3].get<double>(), curve[4].get<double>());
+    }
+
+    const auto name = obj.as<std::string>();
+    const auto it   = namedEasings().find(name);
+    if (it == namedEasings().end())
+        throw std::runtime_error("tween: unknown easing '" + name + "'");
+    return it->second;
+}
+
+static CSharedPointer<CTween> tweenFromSpec(sol::table spec) {
+    auto tween = makeShared<CTween>();
+
+    auto cell = spec.get<sol::object>("cell");
+    if (cell.is<CSharedPointer<CColorCell>>()) {
+        tween->m_property = TWEEN_COLOR;
+        tween->m_cell     = cell.as<CSharedPointer<CColorCell>>();
+        const auto& c     = tween->m_cell->get();
+        tween->m_from     = {c.r, c.g, c.b, c.a};
+    } else {
+        auto element = elementFromLua(spec.get<sol::object>("element"));
+        if (!element)
+            throw std::runtime_error("tween: needs an element or a cell");
+        tween->m_element = element;
+
+        const auto property = spec.get_or<std::string>("property", "");
+        if (property == "margin")
+            tween->m_property = TWEEN_MARGIN;
+        else if (property == "position")
+            tween->m_property = TWEEN_POSITION;
+        else
+            throw std::runtime_error("tween: unknown property '" + property + "', expected margin or position");
+
+        // Elements don't expose their current margin or absolute position
+        if (!spec["from"].valid())
+            throw std::runtime_error("tween: " + property + " needs a from value");
+    }
+
+    if (spec["from"].valid())
+        tween->m_from = tweenValue(tween->m_property, spec.get<sol::object>("from"));
+    tween->m_to       = tweenValue(tween->m_property, spec.get<sol::object>("to"));
+    tween->m_duration = std::chrono::duration<double, std::milli>(spec.get_or("duration", 250.0));
+    tween->m_delay    = std::chrono::duration<double, std::milli>(spec.get_or("delay", 0.0));
+    tween->m_easing   = tweenEasing(spec.get<sol::object>("easing"));
+    tween->m_repeat   = spec.get_or("repeat", 0);
+    tween->m_yoyo     = spec.get_or("yoyo", false);
+
+    auto redraw = spec.get<sol::object>("redraw");
+    if (redraw.is<sol::table>() && !elementFromLua(redraw)) {
+        for (const auto& [_, el] : redraw.as<sol::table>()) {
+            if (auto element = elementFromLua(el))
+                tween->m_redraw.emplace_back(element);
+        }
+    } else if (auto element = elementFromLua(redraw))
+        tween->m_redraw.emplace_back(element);
+
+    auto onDone = spec.get<sol::object>("onDone");
+    if (onDone.is<sol::function>())
+        tween->m_onDone.emplace(onDone.as<sol::protected_function>(), tween.get(), "CTween", "onDone");
+
+    return tween;
+}
+
+void registerAnimation(sol::state& lua) {
+    lua.new_usertype<CColorCell>("CColorCell",
+        sol::no_constructor,
+        "get", &CColorCell::get,
+        "set", &CColorCell::set,
+        // cell:bind(element): repaint element whenever the cell changes
+        "bind", [](CColorCell& cell, sol::object obj) {
+            auto element = elementFromLua(obj);
+            if (!element)
+                throw std::runtime_error("CColorCell:bind: expected an element");
+            cell.bind(element);
+        }
+    );
+    lua["CColorCell"]["new"] = [](const CHyprColor& color) { return makeShared<CColorCell>(color); };
+
+    lua.new_usertype<CTween>("CTween",
+        sol::no_constructor,
+        "cancel", &CTween::cancel,
+        "active", &CTween::active,
+        "progress", &CTween::progress
+    );
+
+    // backend:tween{ element = el, property = "margin" | "position", from = ..., to = ...,
+    //                duration = ms, delay = ms, easing = "easeOutCubic" | { x1, y1, x2, y2 },
+    //                repeat = n (-1 forever), yoyo = bool, onDone = function(completed), redraw = el | { el, ... } }
+    // backend:tween{ cell = colorCell, to = CHyprColor, ... }
+    lua["IBackend"]["tween"] = [](CSharedPointer<IBackend> self, sol::table spec) {
+        auto tween = tweenFromSpec(spec);
+        CAnimator::get().add(self, tween);
+        return tween;
+    };
+
+    lua["Animation"] = lua.create_table_with(
+        // Number of running tweens
+        "active", []() { return CAnimator::get().active(); }
+    );
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,71 @@
+#include <sol/sol.hpp>
+#include <hyprtoolkit-lua/Bundle.hpp>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace Hyprtoolkit::Lua {
+
+static sol::table namesTable(sol::state_view lua, const CBundle* bundle, eBundleEntryKind kind) {
+    sol::table result = lua.create_table();
+    if (!bundle)
+        return result;
+    for (const auto name : bundle->names(kind)) {
+        result.add(std::string(name));
+    }
+    return result;
+}
+
+// Scripts use these for their assets so they run the same packed and unpacked: without
+// a bundle, names are plain paths.
+void registerBundle(sol::state& lua) {
+    lua["Bundle"] = lua.create_table_with(
+        "mounted", [](sol::this_state s) {
+            return CBundle::fromState(s) != nullptr;
+        },
+
+        // Path of the bundle file, nil when running from loose files
+        "file", [](sol::this_state s) -> sol::optional<std::string> {
+            const auto* bundle = CBundle::fromState(s);
+            if (!bundle)
+                return sol::nullopt;
+            return bundle->path();
+        },
+
+        // Bundle.path("icons/logo.png") -> a path CImageBuilder:path() can load
+        "path", [](sol::this_state s, const std::string& name) {
+            auto* bundle = CBundle::fromState(s);
+            if (!bundle)
+                return name;
+
+            auto path = bundle->assetPath(name);
+            if (path.empty())
+                throw std::runtime_error("Bundle.path: no asset '" + name + "' in " + bundle->path());
+            return path;
+        },
+
+        // Bundle.read(name) -> contents, or nil if there is no such asset
+        "read", [](sol::this_state s, const std::string& name) -> sol::optional<std::string> {
+            if (const auto* bundle = CBundle::fromState(s)) {
+                if (!bundle->hasAsset(name))
+                    return sol::nullopt;
+                return std::string(bundle->asset(name));
+            }
+
+            std::ifstream in(name, std::ios::binary);
+            if (!in)
+                return sol::nullopt;
+            return std::string{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        },
+
+        "assets", [](sol::this_state s) {
+            return namesTable(s, CBundle::fromState(s), BUNDLE_ASSET);
+        },
+        "modules", [](sol::this_state s) {
+            return namesTable(s, CBundle::fromState(s), BUNDLE_MODULE);
+        }
+    );
+}
+
+} // namespace Hyprtoolkit::Lua
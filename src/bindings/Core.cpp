@@ -3,9 +3,12 @@
 #include <hyprtoolkit/core/Timer.hpp>
 #include <hyprtoolkit/core/Output.hpp>
 #include <hyprtoolkit/system/Icons.hpp>
+#include <hyprtoolkit-lua/StartupTimings.hpp>
 
 #include "../helpers/SmartPtrAdapter.hpp"
 #include "../helpers/CallbackAdapter.hpp"
+#include "../helpers/Async.hpp"
+#include "../helpers/IconCache.hpp"
 
 using namespace Hyprutils::Memory;
 using namespace Hyprutils::Math;
@@ -44,9 +47,47 @@ void registerSystemIcons(sol::state& lua) {
         "scalable", &ISystemIconDescription::scalable
     );
 
+    // Lookups are memoized per name for the palette's icon theme, misses included
     lua.new_usertype<ISystemIconFactory>("ISystemIconFactory",
         sol::no_constructor,
-        "lookupIcon", &ISystemIconFactory::lookupIcon
+        "lookupIcon", [](CSharedPointer<ISystemIconFactory> self, const std::string& name) {
+            return CIconCache::get().lookup(self, name);
+        },
+
+        // icons:prewarm({ "firefox", "kitty", ... }, function(resolved) end) - resolves in
+        // short slices between events, so later lookupIcon calls for these names are cache hits
+        "prewarm", [](CSharedPointer<ISystemIconFactory> self, sol::table list, sol::optional<sol::function> done) {
+            std::vector<std::string> names;
+            names.reserve(list.size());
+            for (size_t i = 1; i <= list.size(); ++i) {
+                names.push_back(list[i].get<std::string>());
+            }
+
+            std::function<void(size_t)> callback;
+            if (done) {
+                callback = [ref = CLuaFunctionRef(std::move(*done), self.get(), "ISystemIconFactory", "prewarm")](size_t resolved) {
+                    invokeLuaCallback(ref, "prewarm callback", resolved);
+                };
+            }
+            CIconCache::get().prewarm(self, std::move(names), std::move(callback));
+        },
+
+        "clearCache", [](CSharedPointer<ISystemIconFactory>) { CIconCache::get().invalidate(); },
+
+        // { hits, misses, prewarmed, notFound, cleared, entries, hitRate }
+        "cacheStats", [](CSharedPointer<ISystemIconFactory>, sol::this_state s) {
+            const auto stats   = CIconCache::get().stats();
+            const auto lookups = stats.hits + stats.misses;
+            return sol::state_view(s).create_table_with(
+                "hits", stats.hits,
+                "misses", stats.misses,
+                "prewarmed", stats.prewarmed,
+                "notFound", stats.notFound,
+                "cleared", stats.cleared,
+                "entries", stats.entries,
+                "hitRate", lookups ? static_cast<double>(stats.hits) / lookups : 0.0
+            );
+        }
     );
 }
 
@@ -59,13 +100,34 @@ void registerBackend(sol::state& lua) {
     lua.new_usertype<IBackend>("IBackend",
         sol::no_constructor,
 
-        // Static factory methods
-        "create", &IBackend::create,
-        "createWithData", &IBackend::createWithData,
+        // Static factory methods. The new backend's loop also delivers async completions.
+        "create", []() {
+            auto backend = IBackend::create();
+            CMainQueue::get().attach(backend);
+            return backend;
+        },
+        "createWithData", [](const IBackend::SBackendCreationData& data) {
+            auto backend = IBackend::createWithData(data);
+            CMainQueue::get().attach(backend);
+            return backend;
+        },
 
         // Instance methods
         "destroy", &IBackend::destroy,
-        "enterLoop", &IBackend::enterLoop,
+        "enterLoop", [](CSharedPointer<IBackend> self) {
+            // Close the startup timeline: the script is loaded once it hands over to the
+            // loop, and the first idle dispatch follows the first frame
+            auto& timings = CStartupTimings::get();
+            timings.endPhase("script");
+            if (!timings.finished()) {
+                timings.startPhase("firstFrame");
+                self->addIdle([]() {
+                    CStartupTimings::get().endPhase("firstFrame");
+                    CStartupTimings::get().finish();
+                });
+            }
+            self->enterLoop();
+        },
         "getPalette", &IBackend::getPalette,
         "systemIcons", &IBackend::systemIcons,
         "getOutputs", &IBackend::getOutputs,
@@ -75,12 +137,8 @@ void registerBackend(sol::state& lua) {
             auto duration = std::chrono::milliseconds(static_cast<int64_t>(timeoutMs));
             return self->addTimer(
                 duration,
-                [callback](CAtomicSharedPointer<CTimer> timer, void*) {
-                    sol::protected_function_result result = callback(timer);
-                    if (!result.valid()) {
-                        sol::error err = result;
-                        fprintf(stderr, "[Lua] Timer callback error: %s\n", err.what());
-                    }
+                [ref = CLuaFunctionRef(callback, self.get(), "IBackend", "addTimer")](CAtomicSharedPointer<CTimer> timer, void*) {
+                    invokeLuaCallback(ref, "Timer callback", timer);
                 },
                 nullptr,
                 false
@@ -89,23 +147,15 @@ void registerBackend(sol::state& lua) {
 
         // Idle with Lua callback
         "addIdle", [](CSharedPointer<IBackend> self, sol::function callback) {
-            self->addIdle([callback]() {
-                sol::protected_function_result result = callback();
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Idle callback error: %s\n", err.what());
-                }
+            self->addIdle([ref = CLuaFunctionRef(callback, self.get(), "IBackend", "addIdle")]() {
+                invokeLuaCallback(ref, "Idle callback");
             });
         },
 
         // File descriptor callbacks
         "addFd", [](CSharedPointer<IBackend> self, int fd, sol::function callback) {
-            self->addFd(fd, [callback]() {
-                sol::protected_function_result result = callback();
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Fd callback error: %s\n", err.what());
-                }
+            self->addFd(fd, [ref = CLuaFunctionRef(callback, self.get(), "IBackend", "addFd")]() {
+                invokeLuaCallback(ref, "Fd callback");
             });
         },
         "removeFd", &IBackend::removeFd
@@ -14,10 +14,15 @@
 #include <hyprtoolkit/element/Null.hpp>
 #include <hyprtoolkit/element/Line.hpp>
 #include <hyprtoolkit/types/ImageTypes.hpp>
+#include <optional>
 
 #include "../helpers/SmartPtrAdapter.hpp"
-#include "../helpers/CallbackAdapter.hpp"
-#include "../helpers/ColorFnAdapter.hpp"
+#include "../helpers/BuilderTable.hpp"
+#include "../helpers/ElementAdapter.hpp"
+#include "../helpers/ReflowLayout.hpp"
+#include "../helpers/Canvas.hpp"
+#include "../helpers/LogView.hpp"
+#include "../helpers/TextDocument.hpp"
 
 using namespace Hyprutils::Memory;
 using namespace Hyprutils::Math;
@@ -25,373 +30,369 @@ using namespace Hyprutils::Math;
 namespace Hyprtoolkit::Lua {
 
 // Text Element
-void registerTextElement(sol::state& lua) {
-    lua.new_usertype<CTextBuilder>("CTextBuilder",
-        sol::no_constructor,
-        "begin", &CTextBuilder::begin,
-        "text", [](CSharedPointer<CTextBuilder> self, const std::string& t) {
-            return self->text(std::string(t));
-        },
-        "color", [](CSharedPointer<CTextBuilder> self, sol::object colorObj) {
-            return self->color(luaToColorFn(colorObj));
-        },
-        "a", &CTextBuilder::a,
-        "fontSize", [](CSharedPointer<CTextBuilder> self, CFontSize fontSize) {
-            return self->fontSize(std::move(fontSize));
-        },
-        "align", &CTextBuilder::align,
-        "fontFamily", [](CSharedPointer<CTextBuilder> self, const std::string& f) {
-            return self->fontFamily(std::string(f));
-        },
-        "clampSize", [](CSharedPointer<CTextBuilder> self, double x, double y) {
+static constexpr auto TEXT_ELEMENT = describeElement<CTextBuilder, CTextElement>(
+    "CTextBuilder", "CTextElement",
+    std::tuple{
+        SProp<&CTextBuilder::text>{"text"},
+        SProp<&CTextBuilder::color>{"color"},
+        SProp<&CTextBuilder::a>{"a"},
+        SProp<&CTextBuilder::fontSize>{"fontSize"},
+        SProp<&CTextBuilder::align>{"align"},
+        SProp<&CTextBuilder::fontFamily>{"fontFamily"},
+        SProp<&CTextBuilder::noEllipsize>{"noEllipsize"},
+        SProp<&CTextBuilder::size>{"size"},
+        SProp<&CTextBuilder::async>{"async"},
+    },
+    std::tuple{
+        SProp<&CTextBuilder::callback>{"callback"},
+    },
+    std::tuple{
+        SMember{"clampSize", [](CSharedPointer<CTextBuilder> self, double x, double y) {
             return self->clampSize(Vector2D{x, y});
-        },
-        "callback", [](CSharedPointer<CTextBuilder> self, sol::function fn) {
-            return self->callback([fn]() {
-                sol::protected_function_result result = fn();
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Text callback error: %s\n", err.what());
-                }
-            });
-        },
-        "noEllipsize", &CTextBuilder::noEllipsize,
-        "size", [](CSharedPointer<CTextBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "async", &CTextBuilder::async,
-        "commence", &CTextBuilder::commence
-    );
-
-    lua.new_usertype<CTextElement>("CTextElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "rebuild", &CTextElement::rebuild,
-        "size", &CTextElement::size
-    );
-}
+        }},
+    }
+);
 
 // Button Element
-void registerButtonElement(sol::state& lua) {
-    lua.new_usertype<CButtonBuilder>("CButtonBuilder",
-        sol::no_constructor,
-        "begin", &CButtonBuilder::begin,
-        "label", [](CSharedPointer<CButtonBuilder> self, const std::string& l) {
-            return self->label(std::string(l));
-        },
-        "noBorder", &CButtonBuilder::noBorder,
-        "noBg", &CButtonBuilder::noBg,
-        "alignText", &CButtonBuilder::alignText,
-        "fontFamily", [](CSharedPointer<CButtonBuilder> self, const std::string& f) {
-            return self->fontFamily(std::string(f));
-        },
-        "fontSize", [](CSharedPointer<CButtonBuilder> self, CFontSize fontSize) {
-            return self->fontSize(std::move(fontSize));
-        },
-        "onMainClick", [](CSharedPointer<CButtonBuilder> self, sol::function fn) {
-            return self->onMainClick([fn](CSharedPointer<CButtonElement> el) {
-                sol::protected_function_result result = fn(el);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Button onMainClick error: %s\n", err.what());
-                }
-            });
-        },
-        "onRightClick", [](CSharedPointer<CButtonBuilder> self, sol::function fn) {
-            return self->onRightClick([fn](CSharedPointer<CButtonElement> el) {
-                sol::protected_function_result result = fn(el);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Button onRightClick error: %s\n", err.what());
-                }
-            });
-        },
-        "size", [](CSharedPointer<CButtonBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "commence", &CButtonBuilder::commence
-    );
-
-    lua.new_usertype<CButtonElement>("CButtonElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "rebuild", &CButtonElement::rebuild,
-        "size", &CButtonElement::size
-    );
-}
+static constexpr auto BUTTON_ELEMENT = describeElement<CButtonBuilder, CButtonElement>(
+    "CButtonBuilder", "CButtonElement",
+    std::tuple{
+        SProp<&CButtonBuilder::label>{"label"},
+        SProp<&CButtonBuilder::noBorder>{"noBorder"},
+        SProp<&CButtonBuilder::noBg>{"noBg"},
+        SProp<&CButtonBuilder::alignText>{"alignText"},
+        SProp<&CButtonBuilder::fontFamily>{"fontFamily"},
+        SProp<&CButtonBuilder::fontSize>{"fontSize"},
+        SProp<&CButtonBuilder::size>{"size"},
+    },
+    std::tuple{
+        SProp<&CButtonBuilder::onMainClick>{"onMainClick"},
+        SProp<&CButtonBuilder::onRightClick>{"onRightClick"},
+    }
+);
 
 // Textbox Element
-void registerTextboxElement(sol::state& lua) {
-    lua.new_usertype<CTextboxBuilder>("CTextboxBuilder",
-        sol::no_constructor,
-        "begin", &CTextboxBuilder::begin,
-        "placeholder", [](CSharedPointer<CTextboxBuilder> self, const std::string& p) {
-            return self->placeholder(std::string(p));
-        },
-        "defaultText", [](CSharedPointer<CTextboxBuilder> self, const std::string& t) {
-            return self->defaultText(std::string(t));
-        },
-        "onTextEdited", [](CSharedPointer<CTextboxBuilder> self, sol::function fn) {
-            return self->onTextEdited([fn](CSharedPointer<CTextboxElement> el, const std::string& text) {
-                sol::protected_function_result result = fn(el, text);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Textbox onTextEdited error: %s\n", err.what());
-                }
+static constexpr auto TEXTBOX_ELEMENT = describeElement<CTextboxBuilder, CTextboxElement>(
+    "CTextboxBuilder", "CTextboxElement",
+    std::tuple{
+        SProp<&CTextboxBuilder::placeholder>{"placeholder"},
+        SProp<&CTextboxBuilder::defaultText>{"defaultText"},
+        SProp<&CTextboxBuilder::multiline>{"multiline"},
+        SProp<&CTextboxBuilder::size>{"size"},
+    },
+    std::tuple{
+        SProp<&CTextboxBuilder::onTextEdited>{"onTextEdited"},
+    },
+    std::tuple{
+        // Delta mode: document(doc, function(textbox, offset, erased, inserted) end) seeds the
+        // textbox from doc and keeps doc in sync. Lua only sees what changed, 1-based byte
+        // offset included; read the rest through doc:sub() instead of currentText().
+        // Replaces onTextEdited.
+        SMember{"document", [](CSharedPointer<CTextboxBuilder> self, CSharedPointer<CTextDocument> document, sol::optional<sol::function> onDelta) {
+            std::optional<CLuaFunctionRef> ref;
+            if (onDelta)
+                ref.emplace(std::move(*onDelta), self.get(), "CTextboxBuilder", "document");
+
+            self->defaultText(document->text());
+            return self->onTextEdited([document, ref](auto textbox, const std::string& text) {
+                const auto edit = document->sync(text);
+                if (ref && !edit.empty())
+                    invokeLuaCallback(*ref, nullptr, textbox, edit.offset + 1, edit.erased, edit.inserted);
             });
-        },
-        "multiline", &CTextboxBuilder::multiline,
-        "size", [](CSharedPointer<CTextboxBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "commence", &CTextboxBuilder::commence
-    );
-
-    lua.new_usertype<CTextboxElement>("CTextboxElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "rebuild", &CTextboxElement::rebuild,
-        "size", &CTextboxElement::size,
-        "focus", &CTextboxElement::focus,
-        "currentText", [](CTextboxElement* self) {
+        }},
+    },
+    std::tuple{
+        SMember{"focus", &CTextboxElement::focus},
+        SMember{"currentText", [](CTextboxElement* self) {
             return std::string(self->currentText());
-        }
-    );
-}
+        }},
+    }
+);
 
 // Checkbox Element
-void registerCheckboxElement(sol::state& lua) {
-    lua.new_usertype<CCheckboxBuilder>("CCheckboxBuilder",
-        sol::no_constructor,
-        "begin", &CCheckboxBuilder::begin,
-        "toggled", &CCheckboxBuilder::toggled,
-        "onToggled", [](CSharedPointer<CCheckboxBuilder> self, sol::function fn) {
-            return self->onToggled([fn](CSharedPointer<CCheckboxElement> el, bool state) {
-                sol::protected_function_result result = fn(el, state);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Checkbox onToggled error: %s\n", err.what());
-                }
-            });
-        },
-        "size", [](CSharedPointer<CCheckboxBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "commence", &CCheckboxBuilder::commence
-    );
-
-    lua.new_usertype<CCheckboxElement>("CCheckboxElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "rebuild", &CCheckboxElement::rebuild,
-        "size", &CCheckboxElement::size
-    );
-}
+static constexpr auto CHECKBOX_ELEMENT = describeElement<CCheckboxBuilder, CCheckboxElement>(
+    "CCheckboxBuilder", "CCheckboxElement",
+    std::tuple{
+        SProp<&CCheckboxBuilder::toggled>{"toggled"},
+        SProp<&CCheckboxBuilder::size>{"size"},
+    },
+    std::tuple{
+        SProp<&CCheckboxBuilder::onToggled>{"onToggled"},
+    }
+);
 
 // Slider Element
-void registerSliderElement(sol::state& lua) {
-    lua.new_usertype<CSliderBuilder>("CSliderBuilder",
-        sol::no_constructor,
-        "begin", &CSliderBuilder::begin,
-        "min", &CSliderBuilder::min,
-        "max", &CSliderBuilder::max,
-        "val", &CSliderBuilder::val,
-        "snapInt", &CSliderBuilder::snapInt,
-        "onChanged", [](CSharedPointer<CSliderBuilder> self, sol::function fn) {
-            return self->onChanged([fn](CSharedPointer<CSliderElement> el, float value) {
-                sol::protected_function_result result = fn(el, value);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Slider onChanged error: %s\n", err.what());
-                }
-            });
-        },
-        "size", [](CSharedPointer<CSliderBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "commence", &CSliderBuilder::commence
-    );
-
-    lua.new_usertype<CSliderElement>("CSliderElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "rebuild", &CSliderElement::rebuild,
-        "size", &CSliderElement::size,
-        "sliding", &CSliderElement::sliding
-    );
-}
+static constexpr auto SLIDER_ELEMENT = describeElement<CSliderBuilder, CSliderElement>(
+    "CSliderBuilder", "CSliderElement",
+    std::tuple{
+        SProp<&CSliderBuilder::min>{"min"},
+        SProp<&CSliderBuilder::max>{"max"},
+        SProp<&CSliderBuilder::val>{"val"},
+        SProp<&CSliderBuilder::snapInt>{"snapInt"},
+        SProp<&CSliderBuilder::size>{"size"},
+    },
+    std::tuple{
+        SProp<&CSliderBuilder::onChanged>{"onChanged"},
+    },
+    std::tuple{},
+    std::tuple{
+        SMember{"sliding", &CSliderElement::sliding},
+    }
+);
 
 // Combobox Element
-void registerComboboxElement(sol::state& lua) {
-    lua.new_usertype<CComboboxBuilder>("CComboboxBuilder",
-        sol::no_constructor,
-        "begin", &CComboboxBuilder::begin,
-        "items", [](CSharedPointer<CComboboxBuilder> self, sol::table itemsTable) {
-            std::vector<std::string> items;
-            for (size_t i = 1; i <= itemsTable.size(); ++i) {
-                items.push_back(itemsTable[i].get<std::string>());
-            }
-            return self->items(std::move(items));
-        },
-        "currentItem", &CComboboxBuilder::currentItem,
-        "onChanged", [](CSharedPointer<CComboboxBuilder> self, sol::function fn) {
-            return self->onChanged([fn](CSharedPointer<CComboboxElement> el, size_t idx) {
-                sol::protected_function_result result = fn(el, idx);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Combobox onChanged error: %s\n", err.what());
-                }
-            });
-        },
-        "size", [](CSharedPointer<CComboboxBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "commence", &CComboboxBuilder::commence
-    );
-
-    lua.new_usertype<CComboboxElement>("CComboboxElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "rebuild", &CComboboxElement::rebuild,
-        "size", &CComboboxElement::size,
-        "current", &CComboboxElement::current,
-        "setCurrent", &CComboboxElement::setCurrent
-    );
-}
+static constexpr auto COMBOBOX_ELEMENT = describeElement<CComboboxBuilder, CComboboxElement>(
+    "CComboboxBuilder", "CComboboxElement",
+    std::tuple{
+        SProp<&CComboboxBuilder::items>{"items"},
+        SProp<&CComboboxBuilder::currentItem>{"currentItem"},
+        SProp<&CComboboxBuilder::size>{"size"},
+    },
+    std::tuple{
+        SProp<&CComboboxBuilder::onChanged>{"onChanged"},
+    },
+    std::tuple{},
+    std::tuple{
+        SMember{"current", &CComboboxElement::current},
+        SMember{"setCurrent", &CComboboxElement::setCurrent},
+    }
+);
 
 // Spinbox Element
-void registerSpinboxElement(sol::state& lua) {
-    lua.new_usertype<CSpinboxBuilder>("CSpinboxBuilder",
-        sol::no_constructor,
-        "begin", &CSpinboxBuilder::begin,
-        "label", [](CSharedPointer<CSpinboxBuilder> self, const std::string& l) {
-            return self->label(std::string(l));
-        },
-        "items", [](CSharedPointer<CSpinboxBuilder> self, sol::table itemsTable) {
-            std::vector<std::string> items;
-            for (size_t i = 1; i <= itemsTable.size(); ++i) {
-                items.push_back(itemsTable[i].get<std::string>());
-            }
-            return self->items(std::move(items));
-        },
-        "currentItem", &CSpinboxBuilder::currentItem,
-        "onChanged", [](CSharedPointer<CSpinboxBuilder> self, sol::function fn) {
-            return self->onChanged([fn](CSharedPointer<CSpinboxElement> el, size_t idx) {
-                sol::protected_function_result result = fn(el, idx);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Spinbox onChanged error: %s\n", err.what());
-                }
-            });
-        },
-        "fill", &CSpinboxBuilder::fill,
-        "size", [](CSharedPointer<CSpinboxBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "commence", &CSpinboxBuilder::commence
-    );
-
-    lua.new_usertype<CSpinboxElement>("CSpinboxElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "rebuild", &CSpinboxElement::rebuild,
-        "size", &CSpinboxElement::size,
-        "current", &CSpinboxElement::current,
-        "setCurrent", &CSpinboxElement::setCurrent
-    );
-}
+static constexpr auto SPINBOX_ELEMENT = describeElement<CSpinboxBuilder, CSpinboxElement>(
+    "CSpinboxBuilder", "CSpinboxElement",
+    std::tuple{
+        SProp<&CSpinboxBuilder::label>{"label"},
+        SProp<&CSpinboxBuilder::items>{"items"},
+        SProp<&CSpinboxBuilder::currentItem>{"currentItem"},
+        SProp<&CSpinboxBuilder::fill>{"fill"},
+        SProp<&CSpinboxBuilder::size>{"size"},
+    },
+    std::tuple{
+        SProp<&CSpinboxBuilder::onChanged>{"onChanged"},
+    },
+    std::tuple{},
+    std::tuple{
+        SMember{"current", &CSpinboxElement::current},
+        SMember{"setCurrent", &CSpinboxElement::setCurrent},
+    }
+);
 
 // Rectangle Element
-void registerRectangleElement(sol::state& lua) {
-    lua.new_usertype<CRectangleBuilder>("CRectangleBuilder",
-        sol::no_constructor,
-        "begin", &CRectangleBuilder::begin,
-        "color", [](CSharedPointer<CRectangleBuilder> self, sol::object colorObj) {
-            return self->color(luaToColorFn(colorObj));
-        },
-        "borderColor", [](CSharedPointer<CRectangleBuilder> self, sol::object colorObj) {
-            return self->borderColor(luaToColorFn(colorObj));
-        },
-        "rounding", &CRectangleBuilder::rounding,
-        "borderThickness", &CRectangleBuilder::borderThickness,
-        "size", [](CSharedPointer<CRectangleBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "commence", &CRectangleBuilder::commence
-    );
-
-    lua.new_usertype<CRectangleElement>("CRectangleElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "rebuild", &CRectangleElement::rebuild,
-        "size", &CRectangleElement::size
-    );
-}
+static constexpr auto RECTANGLE_ELEMENT = describeElement<CRectangleBuilder, CRectangleElement>(
+    "CRectangleBuilder", "CRectangleElement",
+    std::tuple{
+        SProp<&CRectangleBuilder::color>{"color"},
+        SProp<&CRectangleBuilder::borderColor>{"borderColor"},
+        SProp<&CRectangleBuilder::rounding>{"rounding"},
+        SProp<&CRectangleBuilder::borderThickness>{"borderThickness"},
+        SProp<&CRectangleBuilder::size>{"size"},
+    }
+);
 
 // Column Layout Element
-void registerColumnLayoutElement(sol::state& lua) {
-    lua.new_usertype<CColumnLayoutBuilder>("CColumnLayoutBuilder",
-        sol::no_constructor,
-        "begin", &CColumnLayoutBuilder::begin,
-        "gap", &CColumnLayoutBuilder::gap,
-        "size", [](CSharedPointer<CColumnLayoutBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "commence", &CColumnLayoutBuilder::commence
-    );
-
-    lua.new_usertype<CColumnLayoutElement>("CColumnLayoutElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "rebuild", &CColumnLayoutElement::rebuild,
-        "size", &CColumnLayoutElement::size
-    );
-}
+static constexpr auto COLUMN_LAYOUT_ELEMENT = describeElement<CColumnLayoutBuilder, CColumnLayoutElement>(
+    "CColumnLayoutBuilder", "CColumnLayoutElement",
+    std::tuple{
+        SProp<&CColumnLayoutBuilder::gap>{"gap"},
+        SProp<&CColumnLayoutBuilder::size>{"size"},
+    }
+);
 
 // Row Layout Element
-void registerRowLayoutElement(sol::state& lua) {
-    lua.new_usertype<CRowLayoutBuilder>("CRowLayoutBuilder",
-        sol::no_constructor,
-        "begin", &CRowLayoutBuilder::begin,
-        "gap", &CRowLayoutBuilder::gap,
-        "size", [](CSharedPointer<CRowLayoutBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "commence", &CRowLayoutBuilder::commence
-    );
-
-    lua.new_usertype<CRowLayoutElement>("CRowLayoutElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "size", &CRowLayoutElement::size
-    );
+static constexpr auto ROW_LAYOUT_ELEMENT = describeElement<CRowLayoutBuilder, CRowLayoutElement>(
+    "CRowLayoutBuilder", "CRowLayoutElement",
+    std::tuple{
+        SProp<&CRowLayoutBuilder::gap>{"gap"},
+        SProp<&CRowLayoutBuilder::size>{"size"},
+    }
+);
+
+// Members shared by the grid and flow layouts
+template <typename Layout>
+static constexpr auto reflowLayoutMembers() {
+    return std::tuple{
+        SMember{"addChild", [](Layout* self, sol::object child) {
+            auto element = elementFromLua(child);
+            if (!element)
+                throw std::runtime_error("addChild: argument is not a valid element type");
+            self->addChild(element);
+        }},
+        SMember{"removeChild", [](Layout* self, sol::object child) {
+            if (auto element = elementFromLua(child))
+                self->removeChild(element);
+        }},
+        SMember{"clearChildren", &Layout::clearChildren},
+        SMember{"reflow", &Layout::reflow},
+        SMember{"contentSize", &Layout::contentSize},
+        SMember{"element", &Layout::element},
+    };
 }
 
-// Scroll Area Element
-void registerScrollAreaElement(sol::state& lua) {
-    lua.new_usertype<CScrollAreaBuilder>("CScrollAreaBuilder",
-        sol::no_constructor,
-        "begin", &CScrollAreaBuilder::begin,
-        "scrollX", &CScrollAreaBuilder::scrollX,
-        "scrollY", &CScrollAreaBuilder::scrollY,
-        "blockUserScroll", &CScrollAreaBuilder::blockUserScroll,
-        "size", [](CSharedPointer<CScrollAreaBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "commence", &CScrollAreaBuilder::commence
-    );
+// Grid Layout Element
+static constexpr auto GRID_LAYOUT_ELEMENT = describeElement<CGridLayoutBuilder, CGridLayoutElement>(
+    "CGridLayoutBuilder", "CGridLayoutElement",
+    std::tuple{
+        SProp<&CGridLayoutBuilder::columns>{"columns"},
+        SProp<&CGridLayoutBuilder::minCellWidth>{"minCellWidth"},
+        SProp<&CGridLayoutBuilder::gap>{"gap"},
+        SProp<&CGridLayoutBuilder::rowGap>{"rowGap"},
+        SProp<&CGridLayoutBuilder::size>{"size"},
+    },
+    std::tuple{},
+    std::tuple{},
+    std::tuple_cat(reflowLayoutMembers<CGridLayoutElement>(), std::tuple{
+        SMember{"setColumns", &CGridLayoutElement::setColumns},
+        SMember{"columns", &CGridLayoutElement::columns},
+    })
+);
+
+// Flow Layout Element
+static constexpr auto FLOW_LAYOUT_ELEMENT = describeElement<CFlowLayoutBuilder, CFlowLayoutElement>(
+    "CFlowLayoutBuilder", "CFlowLayoutElement",
+    std::tuple{
+        SProp<&CFlowLayoutBuilder::gap>{"gap"},
+        SProp<&CFlowLayoutBuilder::rowGap>{"rowGap"},
+        SProp<&CFlowLayoutBuilder::size>{"size"},
+    },
+    std::tuple{},
+    std::tuple{},
+    reflowLayoutMembers<CFlowLayoutElement>()
+);
+
+// Canvas Element
+static constexpr auto CANVAS_ELEMENT = describeElement<CCanvasBuilder, CCanvasElement>(
+    "CCanvasBuilder", "CCanvasElement",
+    std::tuple{
+        SProp<&CCanvasBuilder::scale>{"scale"},
+        SProp<&CCanvasBuilder::size>{"size"},
+    },
+    std::tuple{},
+    std::tuple{},
+    std::tuple{
+        SMember{"clear", &CCanvasElement::clear},
+        SMember{"rect", &CCanvasElement::rect},
+        SMember{"line", [](CCanvasElement* self, double x0, double y0, double x1, double y1, const CHyprColor& color, sol::optional<float> thickness) {
+            self->line(x0, y0, x1, y1, color, thickness.value_or(1.F));
+        }},
+        // Points as { Vector2D, ... } or flat { x0, y0, x1, y1, ... }
+        SMember{"polyline", [](CCanvasElement* self, sol::table points, const CHyprColor& color, sol::optional<float> thickness) {
+            std::vector<Vector2D> pts;
+            if (points[1].is<Vector2D>()) {
+                for (size_t i = 1; i <= points.size(); ++i) {
+                    pts.push_back(points[i].get<Vector2D>());
+                }
+            } else {
+                for (size_t i = 1; i + 1 <= points.size(); i += 2) {
+                    pts.push_back(Vector2D{points[i].get<double>(), points[i + 1].get<double>()});
+                }
+            }
+            self->polyline(pts, color, thickness.value_or(1.F));
+        }},
+        SMember{"text", [](CCanvasElement* self, double x, double y, const std::string& text, const CHyprColor& color, sol::optional<CFontSize> fontSize) {
+            self->text(x, y, text, color, fontSize.value_or(CFontSize(CFontSize::HT_FONT_TEXT, 1.F)));
+        }},
+        SMember{"image", &CCanvasElement::image},
+        SMember{"commit", &CCanvasElement::commit},
+        SMember{"commandCount", &CCanvasElement::commandCount},
+        SMember{"element", &CCanvasElement::element},
+    }
+);
+
+// Log View Element
+static constexpr auto LOG_VIEW_ELEMENT = describeElement<CLogViewBuilder, CLogViewElement>(
+    "CLogViewBuilder", "CLogViewElement",
+    std::tuple{
+        SProp<&CLogViewBuilder::capacity>{"capacity"},
+        SProp<&CLogViewBuilder::lineHeight>{"lineHeight"},
+        SProp<&CLogViewBuilder::color>{"color"},
+        SProp<&CLogViewBuilder::fontSize>{"fontSize"},
+        SProp<&CLogViewBuilder::fontFamily>{"fontFamily"},
+        SProp<&CLogViewBuilder::size>{"size"},
+    },
+    std::tuple{},
+    std::tuple{},
+    std::tuple{
+        // append("one\ntwo") or append({ "one", "two" }); batch per frame, not per line
+        SMember{"append", [](CLogViewElement* self, sol::object lines) {
+            if (lines.is<sol::table>()) {
+                for (const auto& [_, line] : lines.as<sol::table>()) {
+                    self->append(line.as<std::string_view>());
+                }
+            } else
+                self->append(lines.as<std::string_view>());
+        }},
+        SMember{"clear", &CLogViewElement::clear},
+        SMember{"lineCount", &CLogViewElement::lineCount},
+        SMember{"dropped", &CLogViewElement::dropped},
+        SMember{"line", [](const CLogViewElement* self, size_t index) -> sol::optional<std::string> {
+            if (auto line = self->line(index))
+                return *line;
+            return sol::nullopt;
+        }},
+        SMember{"scrollTo", &CLogViewElement::scrollTo},
+        SMember{"scrollBy", &CLogViewElement::scrollBy},
+        SMember{"scrollToBottom", &CLogViewElement::scrollToBottom},
+        SMember{"following", &CLogViewElement::following},
+        // search("error", ignoreCase, limit) -> { index, ... } for scrollTo
+        SMember{"search", [](const CLogViewElement* self, const std::string& needle, sol::optional<bool> ignoreCase, sol::optional<size_t> limit) {
+            return sol::as_table(self->search(needle, ignoreCase.value_or(false), limit.value_or(SIZE_MAX)));
+        }},
+        SMember{"element", &CLogViewElement::element},
+    }
+);
 
-    lua.new_usertype<CScrollAreaElement>("CScrollAreaElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "size", &CScrollAreaElement::size,
-        "getCurrentScroll", &CScrollAreaElement::getCurrentScroll,
-        "setScroll", &CScrollAreaElement::setScroll
-    );
-}
+// Scroll Area Element
+static constexpr auto SCROLL_AREA_ELEMENT = describeElement<CScrollAreaBuilder, CScrollAreaElement>(
+    "CScrollAreaBuilder", "CScrollAreaElement",
+    std::tuple{
+        SProp<&CScrollAreaBuilder::scrollX>{"scrollX"},
+        SProp<&CScrollAreaBuilder::scrollY>{"scrollY"},
+        SProp<&CScrollAreaBuilder::blockUserScroll>{"blockUserScroll"},
+        SProp<&CScrollAreaBuilder::size>{"size"},
+    },
+    std::tuple{},
+    std::tuple{},
+    std::tuple{
+        SMember{"getCurrentScroll", &CScrollAreaElement::getCurrentScroll},
+        SMember{"setScroll", &CScrollAreaElement::setScroll},
+    }
+);
 
 // Image Element
-void registerImageElement(sol::state& lua) {
+static constexpr auto IMAGE_ELEMENT = describeElement<CImageBuilder, CImageElement>(
+    "CImageBuilder", "CImageElement",
+    std::tuple{
+        SProp<&CImageBuilder::path>{"path"},
+        SProp<&CImageBuilder::icon>{"icon"},
+        SProp<&CImageBuilder::a>{"a"},
+        SProp<&CImageBuilder::fitMode>{"fitMode"},
+        SProp<&CImageBuilder::sync>{"sync"},
+        SProp<&CImageBuilder::rounding>{"rounding"},
+        SProp<&CImageBuilder::size>{"size"},
+    }
+);
+
+// Null Element (Spacer)
+static constexpr auto NULL_ELEMENT = describeElement<CNullBuilder, CNullElement>(
+    "CNullBuilder", "CNullElement",
+    std::tuple{
+        SProp<&CNullBuilder::size>{"size"},
+    }
+);
+
+// Line Element
+static constexpr auto LINE_ELEMENT = describeElement<CLineBuilder, CLineElement>(
+    "CLineBuilder", "CLineElement",
+    std::tuple{
+        SProp<&CLineBuilder::color>{"color"},
+        SProp<&CLineBuilder::thick>{"thick"},
+        SProp<&CLineBuilder::points>{"points"},
+        SProp<&CLineBuilder::size>{"size"},
+    }
+);
+
+void registerImageTypes(sol::state& lua) {
     // Image fit mode enum
     lua.new_enum<eImageFitMode>("ImageFitMode",
         {
@@ -401,98 +402,30 @@ void registerImageElement(sol::state& lua) {
             {"TILE", IMAGE_FIT_MODE_TILE}
         }
     );
-
-    lua.new_usertype<CImageBuilder>("CImageBuilder",
-        sol::no_constructor,
-        "begin", &CImageBuilder::begin,
-        "path", [](CSharedPointer<CImageBuilder> self, const std::string& p) {
-            return self->path(std::string(p));
-        },
-        "icon", &CImageBuilder::icon,
-        "a", &CImageBuilder::a,
-        "fitMode", &CImageBuilder::fitMode,
-        "sync", &CImageBuilder::sync,
-        "rounding", &CImageBuilder::rounding,
-        "size", [](CSharedPointer<CImageBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "commence", &CImageBuilder::commence
-    );
-
-    lua.new_usertype<CImageElement>("CImageElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "rebuild", &CImageElement::rebuild,
-        "size", &CImageElement::size
-    );
-}
-
-// Null Element (Spacer)
-void registerNullElement(sol::state& lua) {
-    lua.new_usertype<CNullBuilder>("CNullBuilder",
-        sol::no_constructor,
-        "begin", &CNullBuilder::begin,
-        "size", [](CSharedPointer<CNullBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "commence", &CNullBuilder::commence
-    );
-
-    lua.new_usertype<CNullElement>("CNullElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "rebuild", &CNullElement::rebuild,
-        "size", &CNullElement::size
-    );
-}
-
-// Line Element
-void registerLineElement(sol::state& lua) {
-    lua.new_usertype<CLineBuilder>("CLineBuilder",
-        sol::no_constructor,
-        "begin", &CLineBuilder::begin,
-        "color", [](CSharedPointer<CLineBuilder> self, sol::object colorObj) {
-            return self->color(luaToColorFn(colorObj));
-        },
-        "thick", &CLineBuilder::thick,
-        "points", [](CSharedPointer<CLineBuilder> self, sol::table pointsTable) {
-            std::vector<Vector2D> points;
-            for (size_t i = 1; i <= pointsTable.size(); ++i) {
-                sol::table pt = pointsTable[i];
-                points.push_back(Vector2D{pt[1].get<double>(), pt[2].get<double>()});
-            }
-            return self->points(std::move(points));
-        },
-        "size", [](CSharedPointer<CLineBuilder> self, CDynamicSize size) {
-            return self->size(std::move(size));
-        },
-        "commence", &CLineBuilder::commence
-    );
-
-    lua.new_usertype<CLineElement>("CLineElement",
-        sol::no_constructor,
-        sol::base_classes, sol::bases<IElement>(),
-        "rebuild", &CLineElement::rebuild,
-        "size", &CLineElement::size
-    );
 }
 
 // Main registration function for all element builders
 void registerElementBuilders(sol::state& lua) {
-    registerTextElement(lua);
-    registerButtonElement(lua);
-    registerTextboxElement(lua);
-    registerCheckboxElement(lua);
-    registerSliderElement(lua);
-    registerComboboxElement(lua);
-    registerSpinboxElement(lua);
-    registerRectangleElement(lua);
-    registerColumnLayoutElement(lua);
-    registerRowLayoutElement(lua);
-    registerScrollAreaElement(lua);
-    registerImageElement(lua);
-    registerNullElement(lua);
-    registerLineElement(lua);
+    registerImageTypes(lua);
+
+    registerElementType(lua, TEXT_ELEMENT);
+    registerElementType(lua, BUTTON_ELEMENT);
+    registerElementType(lua, TEXTBOX_ELEMENT);
+    registerElementType(lua, CHECKBOX_ELEMENT);
+    registerElementType(lua, SLIDER_ELEMENT);
+    registerElementType(lua, COMBOBOX_ELEMENT);
+    registerElementType(lua, SPINBOX_ELEMENT);
+    registerElementType(lua, RECTANGLE_ELEMENT);
+    registerElementType(lua, COLUMN_LAYOUT_ELEMENT);
+    registerElementType(lua, ROW_LAYOUT_ELEMENT);
+    registerElementType(lua, GRID_LAYOUT_ELEMENT);
+    registerElementType(lua, FLOW_LAYOUT_ELEMENT);
+    registerElementType(lua, CANVAS_ELEMENT);
+    registerElementType(lua, LOG_VIEW_ELEMENT);
+    registerElementType(lua, SCROLL_AREA_ELEMENT);
+    registerElementType(lua, IMAGE_ELEMENT);
+    registerElementType(lua, NULL_ELEMENT);
+    registerElementType(lua, LINE_ELEMENT);
 }
 
 } // namespace Hyprtoolkit::Lua
@@ -18,6 +18,7 @@
 
 #include "../helpers/SmartPtrAdapter.hpp"
 #include "../helpers/CallbackAdapter.hpp"
+#include "../helpers/ElementAdapter.hpp"
 
 using namespace Hyprutils::Memory;
 using namespace Hyprutils::Math;
@@ -61,41 +62,12 @@ void registerElement(sol::state& lua) {
         "setPositionFlag", &IElement::setPositionFlag,
         "setAbsolutePosition", &IElement::setAbsolutePosition,
 
-        // Child management - use lambda to handle derived element types
+        // Child management - derived element types are converted to IElement
         "addChild", [](IElement* self, sol::object child) {
-            // Try to extract as CSharedPointer<IElement>
-            if (child.is<CSharedPointer<IElement>>()) {
-                self->addChild(child.as<CSharedPointer<IElement>>());
-                return;
-            }
-            // Try common element types that inherit from IElement
-            // The sol::bases doesn't automatically convert smart pointers
-            #define TRY_ELEMENT_TYPE(T) \
-                if (child.is<CSharedPointer<T>>()) { \
-                    auto ptr = child.as<CSharedPointer<T>>(); \
-                    self->addChild(CSharedPointer<IElement>(ptr)); \
-                    return; \
-                }
-
-            // All element types need to be listed here for proper conversion
-            TRY_ELEMENT_TYPE(CTextElement)
-            TRY_ELEMENT_TYPE(CButtonElement)
-            TRY_ELEMENT_TYPE(CTextboxElement)
-            TRY_ELEMENT_TYPE(CCheckboxElement)
-            TRY_ELEMENT_TYPE(CSliderElement)
-            TRY_ELEMENT_TYPE(CComboboxElement)
-            TRY_ELEMENT_TYPE(CSpinboxElement)
-            TRY_ELEMENT_TYPE(CRectangleElement)
-            TRY_ELEMENT_TYPE(CColumnLayoutElement)
-            TRY_ELEMENT_TYPE(CRowLayoutElement)
-            TRY_ELEMENT_TYPE(CScrollAreaElement)
-            TRY_ELEMENT_TYPE(CImageElement)
-            TRY_ELEMENT_TYPE(CNullElement)
-            TRY_ELEMENT_TYPE(CLineElement)
-
-            #undef TRY_ELEMENT_TYPE
-
-            throw std::runtime_error("addChild: argument is not a valid element type");
+            auto element = elementFromLua(child);
+            if (!element)
+                throw std::runtime_error("addChild: argument is not a valid element type");
+            self->addChild(element);
         },
         "removeChild", &IElement::removeChild,
         "clearChildren", &IElement::clearChildren,
@@ -117,62 +89,38 @@ void registerElement(sol::state& lua) {
         "setReceivesMouse", &IElement::setReceivesMouse,
 
         "setMouseEnter", [](IElement* self, sol::function fn) {
-            self->setMouseEnter([fn](const Vector2D& pos) {
-                sol::protected_function_result result = fn(pos);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] mouseEnter callback error: %s\n", err.what());
-                }
+            self->setMouseEnter([ref = CLuaFunctionRef(fn, self, "IElement", "setMouseEnter")](const Vector2D& pos) {
+                invokeLuaCallback(ref, "mouseEnter callback", pos);
             });
         },
 
         "setMouseLeave", [](IElement* self, sol::function fn) {
-            self->setMouseLeave([fn]() {
-                sol::protected_function_result result = fn();
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] mouseLeave callback error: %s\n", err.what());
-                }
+            self->setMouseLeave([ref = CLuaFunctionRef(fn, self, "IElement", "setMouseLeave")]() {
+                invokeLuaCallback(ref, "mouseLeave callback");
             });
         },
 
         "setMouseMove", [](IElement* self, sol::function fn) {
-            self->setMouseMove([fn](const Vector2D& pos) {
-                sol::protected_function_result result = fn(pos);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] mouseMove callback error: %s\n", err.what());
-                }
+            self->setMouseMove([ref = CLuaFunctionRef(fn, self, "IElement", "setMouseMove")](const Vector2D& pos) {
+                invokeLuaCallback(ref, "mouseMove callback", pos);
             });
         },
 
         "setMouseButton", [](IElement* self, sol::function fn) {
-            self->setMouseButton([fn](Input::eMouseButton button, bool pressed) {
-                sol::protected_function_result result = fn(button, pressed);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] mouseButton callback error: %s\n", err.what());
-                }
+            self->setMouseButton([ref = CLuaFunctionRef(fn, self, "IElement", "setMouseButton")](Input::eMouseButton button, bool pressed) {
+                invokeLuaCallback(ref, "mouseButton callback", button, pressed);
             });
         },
 
         "setMouseAxis", [](IElement* self, sol::function fn) {
-            self->setMouseAxis([fn](Input::eAxisAxis axis, float delta) {
-                sol::protected_function_result result = fn(axis, delta);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] mouseAxis callback error: %s\n", err.what());
-                }
+            self->setMouseAxis([ref = CLuaFunctionRef(fn, self, "IElement", "setMouseAxis")](Input::eAxisAxis axis, float delta) {
+                invokeLuaCallback(ref, "mouseAxis callback", axis, delta);
             });
         },
 
         "setRepositioned", [](IElement* self, sol::function fn) {
-            self->setRepositioned([fn]() {
-                sol::protected_function_result result = fn();
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] repositioned callback error: %s\n", err.what());
-                }
+            self->setRepositioned([ref = CLuaFunctionRef(fn, self, "IElement", "setRepositioned")]() {
+                invokeLuaCallback(ref, "repositioned callback");
             });
         }
     );
@@ -0,0 +1,61 @@
+#include <sol/sol.hpp>
+#include <hyprtoolkit-lua/ErrorLog.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Hyprtoolkit::Lua {
+
+static double secondsSince(std::chrono::steady_clock::time_point tp, std::chrono::steady_clock::time_point now) {
+    return std::chrono::duration<double>(now - tp).count();
+}
+
+void registerErrors(sol::state& lua) {
+    lua["Errors"] = lua.create_table_with(
+        // { { source, message, count, age, since }, ... } newest first; age and since are
+        // seconds since the last and the first occurrence
+        "recent", [](sol::this_state s, sol::optional<size_t> max) {
+            sol::state_view lua(s);
+            sol::table      result = lua.create_table();
+            const auto      now    = std::chrono::steady_clock::now();
+
+            for (const auto& record : CErrorLog::get().recent(max.value_or(SIZE_MAX))) {
+                result.add(lua.create_table_with(
+                    "source", record.source,
+                    "message", record.message,
+                    "count", record.count,
+                    "age", secondsSince(record.last, now),
+                    "since", secondsSince(record.first, now)
+                ));
+            }
+            return result;
+        },
+
+        // Errors.report("sync", "server unreachable") - same folding as binding errors
+        "report", [](const std::string& source, const std::string& message) {
+            CErrorLog::get().report(source, message);
+        },
+
+        // { reported, written, suppressed, dropped, unique }
+        "stats", [](sol::this_state s) {
+            const auto stats = CErrorLog::get().stats();
+            return sol::state_view(s).create_table_with(
+                "reported", stats.reported,
+                "written", stats.written,
+                "suppressed", stats.suppressed,
+                "dropped", stats.dropped,
+                "unique", stats.unique
+            );
+        },
+
+        // Errors.setLimits{ windowMs = 1000, perSecond = 20 }
+        "setLimits", [](sol::table limits) {
+            CErrorLog::get().setLimits(std::chrono::milliseconds(limits.get_or<int64_t>("windowMs", 1000)), limits.get_or<size_t>("perSecond", 20));
+        },
+
+        "flush", []() { CErrorLog::get().flush(); },
+        "clear", []() { CErrorLog::get().clear(); }
+    );
+}
+
+} // namespace Hyprtoolkit::Lua
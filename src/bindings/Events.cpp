@@ -0,0 +1,44 @@
+#include <sol/sol.hpp>
+#include <stdexcept>
+#include <string>
+
+#include "../helpers/EventQueue.hpp"
+
+namespace Hyprtoolkit::Lua {
+
+static CEventQueue& queueOf(sol::this_state s, const char* fn) {
+    auto* queue = CEventQueue::fromState(s);
+    if (!queue)
+        throw std::runtime_error(std::string(fn) + ": no event queue, the state was not created through CLuaState");
+    return *queue;
+}
+
+// Events the host posts with CLuaState::post, from any thread
+void registerEvents(sol::state& lua) {
+    lua["Events"] = lua.create_table_with(
+        // Events.subscribe("sensor", function(batch) for _, v in ipairs(batch) do ... end end)
+        // batch holds every payload posted since the last delivery, oldest first
+        "subscribe", [](sol::this_state s, const std::string& event, sol::protected_function fn) {
+            return queueOf(s, "Events.subscribe").subscribe(event, std::move(fn));
+        },
+
+        "unsubscribe", [](sol::this_state s, uint64_t id) {
+            return queueOf(s, "Events.unsubscribe").unsubscribe(id);
+        },
+
+        // { posted, delivered, dropped, pending, wakeups, batches }
+        "stats", [](sol::this_state s) {
+            const auto stats = queueOf(s, "Events.stats").stats();
+            return sol::state_view(s).create_table_with(
+                "posted", stats.posted,
+                "delivered", stats.delivered,
+                "dropped", stats.dropped,
+                "pending", stats.posted - stats.delivered - stats.dropped,
+                "wakeups", stats.wakeups,
+                "batches", stats.batches
+            );
+        }
+    );
+}
+
+} // namespace Hyprtoolkit::Lua
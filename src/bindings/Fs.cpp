@@ -0,0 +1,339 @@
+#include <sol/sol.hpp>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "../helpers/SmartPtrAdapter.hpp"
+#include "../helpers/CallbackAdapter.hpp"
+#include "../helpers/RefTracker.hpp"
+#include "../helpers/Async.hpp"
+
+using namespace Hyprutils::Memory;
+
+namespace Hyprtoolkit::Lua {
+
+// Blocking helpers, run on worker threads only. They return errno on failure.
+
+static int readWholeFile(const std::string& path, std::string& out) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return errno;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        out.reserve(st.st_size);
+
+    char buf[65536];
+    while (true) {
+        const ssize_t n = read(fd, buf, sizeof(buf));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            const int err = errno;
+            close(fd);
+            return err;
+        }
+        if (n == 0)
+            break;
+        out.append(buf, n);
+    }
+
+    close(fd);
+    return 0;
+}
+
+static int writeAll(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        const ssize_t n = write(fd, data.data() + written, data.size() - written);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return errno;
+        }
+        written += n;
+    }
+    return 0;
+}
+
+static int writeWholeFile(const std::string& path, const std::string& data, bool append, bool atomic) {
+    // Atomic writes go to a sibling temp file that replaces the target once synced.
+    // Its name is unique per write, concurrent writes to one path each get their own.
+    static std::atomic<uint64_t> nextTemp = 1;
+    const bool                   temp     = atomic && !append;
+    const std::string            target   = temp ? path + ".tmp." + std::to_string(getpid()) + "." + std::to_string(nextTemp++) : path;
+    const int                    flags    = O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC) | (temp ? O_EXCL | O_NOFOLLOW : 0);
+    const int                    fd       = open(target.c_str(), flags, 0644);
+    if (fd < 0)
+        return errno;
+
+    int err = writeAll(fd, data);
+    if (!err && atomic && fsync(fd) != 0)
+        err = errno;
+    if (close(fd) != 0 && !err)
+        err = errno;
+
+    if (temp) {
+        if (!err && rename(target.c_str(), path.c_str()) != 0)
+            err = errno;
+        if (err)
+            unlink(target.c_str());
+    }
+
+    return err;
+}
+
+// Lua side of in-flight operations, only touched on the main thread. Workers refer
+// to an operation by id so they never copy or release Lua references.
+struct SFsOperation {
+    CLuaFunctionRef callback;
+};
+
+// A streaming read. Only one chunk is in flight at a time: the next one is queued
+// after the previous one was handed to Lua, so a slow consumer slows the reader
+// down instead of piling chunks up in memory.
+class CChunkedRead {
+  public:
+    CChunkedRead(std::string path, size_t chunkSize, sol::protected_function onChunk, sol::protected_function onDone) :
+        m_path(std::move(path)), m_chunkSize(chunkSize) {
+        m_onChunk.emplace(std::move(onChunk), this, "fs", "onChunk");
+        m_onDone.emplace(std::move(onDone), this, "fs", "onDone");
+    }
+
+    void cancel() {
+        m_cancelled = true;
+    }
+
+    size_t bytesRead() const {
+        return m_offset;
+    }
+
+    bool done() const {
+        return m_done;
+    }
+
+    std::string                    m_path;
+    size_t                         m_chunkSize = 0;
+    std::optional<CLuaFunctionRef> m_onChunk;
+    std::optional<CLuaFunctionRef> m_onDone;
+    int                            m_fd        = -1;
+    size_t                         m_offset    = 0;
+    bool                           m_cancelled = false;
+    bool                           m_done      = false;
+};
+
+// Leaked like the async singletons: destroying them at exit would release Lua
+// references after the state is closed
+static uint64_t nextOperationId = 1;
+static auto*    operations      = new std::unordered_map<uint64_t, SFsOperation>();
+static auto*    chunkedReads    = new std::unordered_map<uint64_t, CSharedPointer<CChunkedRead>>();
+
+static uint64_t addOperation(sol::protected_function callback, const char* event) {
+    const auto id = nextOperationId++;
+    operations->emplace(id, SFsOperation{CLuaFunctionRef(std::move(callback), operations, "fs", event)});
+    return id;
+}
+
+template <typename... Args>
+static void completeOperation(uint64_t id, const char* what, Args&&... args) {
+    auto it = operations->find(id);
+    if (it == operations->end())
+        return;
+
+    auto op = std::move(it->second);
+    operations->erase(it);
+    invokeLuaCallback(op.callback, what, std::forward<Args>(args)...);
+}
+
+static void finishChunkedRead(uint64_t id, bool ok, const std::string& error) {
+    auto it = chunkedReads->find(id);
+    if (it == chunkedReads->end())
+        return;
+
+    auto read = it->second;
+    chunkedReads->erase(it);
+
+    if (read->m_fd >= 0)
+        close(read->m_fd);
+    read->m_fd   = -1;
+    read->m_done = true;
+
+    // Release both functions, they may hold the handle that holds them
+    auto onDone = std::move(*read->m_onDone);
+    read->m_onDone.reset();
+    read->m_onChunk.reset();
+
+    if (ok)
+        invokeLuaCallback(onDone, "fs.readChunked onDone callback", true, sol::lua_nil);
+    else
+        invokeLuaCallback(onDone, "fs.readChunked onDone callback", false, error);
+}
+
+static void queueChunk(uint64_t id, const std::string& path, int fd, size_t offset, size_t chunkSize) {
+    CWorkerPool::get().submit([id, path, fd, offset, chunkSize]() mutable {
+        int err = 0;
+        if (fd < 0) {
+            fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                err = errno;
+        }
+
+        std::string chunk;
+        if (!err) {
+            chunk.resize(chunkSize);
+            ssize_t n;
+            do {
+                n = pread(fd, chunk.data(), chunkSize, offset);
+            } while (n < 0 && errno == EINTR);
+
+            if (n < 0) {
+                err = errno;
+                chunk.clear();
+            } else
+                chunk.resize(n);
+        }
+
+        CMainQueue::get().post([id, fd, err, chunk = std::move(chunk)]() {
+            auto it = chunkedReads->find(id);
+            if (it == chunkedReads->end()) {
+                if (fd >= 0)
+                    close(fd);
+                return;
+            }
+
+            auto read  = it->second;
+            read->m_fd = fd;
+
+            if (err)
+                return finishChunkedRead(id, false, strerror(err));
+            if (read->m_cancelled)
+                return finishChunkedRead(id, false, "cancelled");
+            if (chunk.empty())
+                return finishChunkedRead(id, true, "");
+
+            read->m_offset += chunk.size();
+
+            // onChunk returning false, or raising, stops the read
+            const auto result    = invokeLuaCallback(*read->m_onChunk, "fs.readChunked onChunk callback", std::string_view(chunk));
+            const bool keepGoing = result.valid() && !(result.get_type() == sol::type::boolean && !result.get<bool>());
+
+            if (!keepGoing || read->m_cancelled)
+                return finishChunkedRead(id, false, "cancelled");
+
+            queueChunk(id, read->m_path, read->m_fd, read->m_offset, read->m_chunkSize);
+        });
+    });
+}
+
+static void requireLoop() {
+    if (!CMainQueue::get().attached())
+        throw std::runtime_error("fs: async calls complete on the backend loop, create a backend first");
+}
+
+static void writeAsync(const std::string& path, std::string data, bool append, bool atomic, sol::protected_function callback) {
+    requireLoop();
+    const auto id = addOperation(std::move(callback), "writeAsync");
+    CWorkerPool::get().submit([id, path, data = std::move(data), append, atomic]() {
+        const int err = writeWholeFile(path, data, append, atomic);
+        CMainQueue::get().post([id, err]() {
+            if (err)
+                completeOperation(id, "fs.writeAsync callback", false, std::string(strerror(err)));
+            else
+                completeOperation(id, "fs.writeAsync callback", true);
+        });
+    });
+}
+
+void registerFs(sol::state& lua) {
+    lua.new_usertype<CChunkedRead>("CChunkedRead",
+        sol::no_constructor,
+        "cancel", &CChunkedRead::cancel,
+        "bytesRead", &CChunkedRead::bytesRead,
+        "done", &CChunkedRead::done
+    );
+
+    lua["fs"] = lua.create_table_with(
+        // fs.readAsync(path, function(data, err) end)
+        "readAsync", [](const std::string& path, sol::protected_function callback) {
+            requireLoop();
+            const auto id = addOperation(std::move(callback), "readAsync");
+            CWorkerPool::get().submit([id, path]() {
+                std::string data;
+                const int   err = readWholeFile(path, data);
+                CMainQueue::get().post([id, err, data = std::move(data)]() {
+                    if (err)
+                        completeOperation(id, "fs.readAsync callback", sol::lua_nil, std::string(strerror(err)));
+                    else
+                        completeOperation(id, "fs.readAsync callback", data);
+                });
+            });
+        },
+
+        // fs.writeAsync(path, data, [{ append = bool, atomic = bool }], function(ok, err) end)
+        "writeAsync", sol::overload(
+            [](const std::string& path, std::string data, sol::table options, sol::protected_function callback) {
+                writeAsync(path, std::move(data), options.get_or("append", false), options.get_or("atomic", false), std::move(callback));
+            },
+            [](const std::string& path, std::string data, sol::protected_function callback) {
+                writeAsync(path, std::move(data), false, false, std::move(callback));
+            }
+        ),
+
+        // fs.statAsync(path, function(st, err) end), st = { size, mtime, mode, isFile, isDir }
+        "statAsync", [](const std::string& path, sol::protected_function callback) {
+            requireLoop();
+            const auto id = addOperation(std::move(callback), "statAsync");
+            CWorkerPool::get().submit([id, path]() {
+                struct stat st;
+                const int   err = stat(path.c_str(), &st) == 0 ? 0 : errno;
+                CMainQueue::get().post([id, err, st]() {
+                    auto it = operations->find(id);
+                    if (it == operations->end())
+                        return;
+                    if (err)
+                        return completeOperation(id, "fs.statAsync callback", sol::lua_nil, std::string(strerror(err)));
+
+                    sol::state_view lua(it->second.callback.function().lua_state());
+                    sol::table      result = lua.create_table_with(
+                        "size", static_cast<double>(st.st_size),
+                        "mtime", static_cast<double>(st.st_mtim.tv_sec) + st.st_mtim.tv_nsec / 1e9,
+                        "mode", st.st_mode & 07777,
+                        "isFile", S_ISREG(st.st_mode),
+                        "isDir", S_ISDIR(st.st_mode)
+                    );
+                    completeOperation(id, "fs.statAsync callback", result);
+                });
+            });
+        },
+
+        // fs.readChunked(path, [{ chunkSize = bytes }], function(chunk) end, function(ok, err) end)
+        // onChunk may return false to stop. Returns a CChunkedRead handle.
+        "readChunked", [](const std::string& path, sol::variadic_args va) {
+            requireLoop();
+
+            size_t chunkSize = 64 * 1024;
+            size_t arg       = 0;
+            if (va.size() > 0 && va[0].get_type() == sol::type::table) {
+                sol::table options = va[0];
+                chunkSize          = std::max<size_t>(1, options.get_or<size_t>("chunkSize", chunkSize));
+                ++arg;
+            }
+            if (va.size() < arg + 2)
+                throw std::runtime_error("fs.readChunked: expected onChunk and onDone functions");
+
+            auto       read = makeShared<CChunkedRead>(path, chunkSize, va[arg].as<sol::protected_function>(), va[arg + 1].as<sol::protected_function>());
+            const auto id   = nextOperationId++;
+            chunkedReads->emplace(id, read);
+            queueChunk(id, path, -1, 0, chunkSize);
+            return read;
+        }
+    );
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,218 @@
+#include <sol/sol.hpp>
+#include <hyprtoolkit/element/Image.hpp>
+#include <array>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <variant>
+
+#include "../helpers/SmartPtrAdapter.hpp"
+#include "../helpers/CallbackAdapter.hpp"
+#include "../helpers/ImageBuffer.hpp"
+#include "../helpers/RuntimeImage.hpp"
+#include "../helpers/Async.hpp"
+
+using namespace Hyprutils::Memory;
+
+namespace Hyprtoolkit::Lua {
+
+static std::array<double, 20> grayscaleMatrix() {
+    // Rec. 709 luma
+    return {0.2126, 0.7152, 0.0722, 0, 0, 0.2126, 0.7152, 0.0722, 0, 0, 0.2126, 0.7152, 0.0722, 0, 0, 0, 0, 0, 1, 0};
+}
+
+static std::array<double, 20> invertMatrix() {
+    return {-1, 0, 0, 0, 1, 0, -1, 0, 0, 1, 0, 0, -1, 0, 1, 0, 0, 0, 1, 0};
+}
+
+static std::array<double, 20> brightnessMatrix(double factor) {
+    return {factor, 0, 0, 0, 0, 0, factor, 0, 0, 0, 0, 0, factor, 0, 0, 0, 0, 0, 1, 0};
+}
+
+static std::array<double, 20> saturationMatrix(double s) {
+    const double r = 0.2126 * (1 - s), g = 0.7152 * (1 - s), b = 0.0722 * (1 - s);
+    return {r + s, g, b, 0, 0, r, g + s, b, 0, 0, r, g, b + s, 0, 0, 0, 0, 0, 1, 0};
+}
+
+static SImageOp colorOp(const std::array<double, 20>& matrix) {
+    return SImageOp{IMAGE_OP_COLOR_MATRIX, matrix};
+}
+
+// { {"thumbnail", 256}, {"rotate", 90}, "grayscale", ... } -> ops. Parsed on the main
+// thread so workers never see Lua values.
+static std::vector<SImageOp> parseOps(const sol::table& list) {
+    std::vector<SImageOp> ops;
+    for (size_t i = 1; i <= list.size(); ++i) {
+        sol::object entry = list[i];
+        sol::table  spec;
+        std::string name;
+        if (entry.is<std::string>())
+            name = entry.as<std::string>();
+        else if (entry.is<sol::table>()) {
+            spec = entry.as<sol::table>();
+            name = spec.get_or<std::string>(1, "");
+        }
+
+        auto num = [&](size_t idx, double fallback) { return spec.valid() ? spec.get_or<double>(idx, fallback) : fallback; };
+
+        SImageOp op;
+        if (name == "scale")
+            op = SImageOp{IMAGE_OP_SCALE, {num(2, 1), num(3, num(2, 1))}};
+        else if (name == "thumbnail")
+            op = SImageOp{IMAGE_OP_THUMBNAIL, {num(2, 256), num(3, num(2, 256))}};
+        else if (name == "crop")
+            op = SImageOp{IMAGE_OP_CROP, {num(2, 0), num(3, 0), num(4, 1), num(5, 1)}};
+        else if (name == "rotate")
+            op = SImageOp{IMAGE_OP_ROTATE, {num(2, 0)}};
+        else if (name == "blur")
+            op = SImageOp{IMAGE_OP_BLUR, {num(2, 2)}};
+        else if (name == "grayscale")
+            op = colorOp(grayscaleMatrix());
+        else if (name == "invert")
+            op = colorOp(invertMatrix());
+        else if (name == "brightness")
+            op = colorOp(brightnessMatrix(num(2, 1)));
+        else if (name == "saturation")
+            op = colorOp(saturationMatrix(num(2, 1)));
+        else if (name == "colorMatrix") {
+            op.op = IMAGE_OP_COLOR_MATRIX;
+            sol::table m = spec.get<sol::table>(2);
+            for (size_t k = 0; k < 20; ++k) {
+                op.args[k] = m.get_or<double>(k + 1, 0);
+            }
+        } else
+            throw std::runtime_error("ImageBuffer: unknown op '" + name + "'");
+
+        ops.push_back(op);
+    }
+    return ops;
+}
+
+static CSharedPointer<CImageBuffer> wrap(SPixels&& pixels, std::string file = "") {
+    return makeShared<CImageBuffer>(std::make_shared<const SPixels>(std::move(pixels)), std::move(file));
+}
+
+// Lua side of in-flight jobs, main thread only; workers refer to a job by id.
+// Leaked, like the fs operations, so no reference is released after lua_close.
+static uint64_t nextJobId = 1;
+static auto*    jobs      = new std::unordered_map<uint64_t, CLuaFunctionRef>();
+
+static void requireLoop(const char* fn) {
+    if (!CMainQueue::get().attached())
+        throw std::runtime_error(std::string(fn) + ": no backend loop, create one with IBackend.create() first");
+}
+
+// Loads (when source is a path) and processes on a worker, then hands Lua a buffer
+// whose PNG is already written, so CImageBuilder:buffer() costs nothing on the UI thread
+static void runAsync(std::variant<std::string, std::shared_ptr<const SPixels>> source, std::vector<SImageOp> ops, sol::protected_function callback, const char* event) {
+    requireLoop(event);
+
+    const auto id = nextJobId++;
+    jobs->emplace(id, CLuaFunctionRef(std::move(callback), jobs, "ImageBuffer", event));
+
+    CWorkerPool::get().submit([id, source = std::move(source), ops = std::move(ops)]() {
+        std::string            error;
+        std::optional<SPixels> result;
+        if (auto* path = std::get_if<std::string>(&source))
+            result = loadPixels(*path, error);
+        else
+            result = *std::get<std::shared_ptr<const SPixels>>(source);
+
+        std::string file;
+        if (result) {
+            result = applyImageOps(*result, ops);
+            file   = runtimeImagePath("imageop", id, 0);
+            if (!writeRuntimeImage(file, result->data.data(), result->width, result->height))
+                file.clear();
+        }
+
+        CMainQueue::get().post([id, error = std::move(error), result = std::move(result), file = std::move(file)]() mutable {
+            auto it = jobs->find(id);
+            if (it == jobs->end())
+                return;
+
+            auto callback = std::move(it->second);
+            jobs->erase(it);
+            if (result)
+                invokeLuaCallback(callback, "ImageBuffer callback", wrap(std::move(*result), std::move(file)), sol::lua_nil);
+            else
+                invokeLuaCallback(callback, "ImageBuffer callback", sol::lua_nil, error);
+        });
+    });
+}
+
+static CSharedPointer<CImageBuffer> applySync(const CImageBuffer& self, const std::vector<SImageOp>& ops) {
+    return wrap(applyImageOps(*self.pixels(), ops));
+}
+
+void registerImageOps(sol::state& lua) {
+    lua.new_usertype<CImageBuffer>("CImageBuffer",
+        sol::no_constructor,
+        "width", &CImageBuffer::width,
+        "height", &CImageBuffer::height,
+        "file", &CImageBuffer::file,
+
+        // buffer:apply({ {"thumbnail", 256}, "grayscale" }) -> new buffer
+        "apply", [](const CImageBuffer& self, sol::table ops) {
+            return applySync(self, parseOps(ops));
+        },
+        // buffer:applyAsync(ops, function(buffer, err) end)
+        "applyAsync", [](const CImageBuffer& self, sol::table ops, sol::protected_function callback) {
+            runAsync(self.pixels(), parseOps(ops), std::move(callback), "applyAsync");
+        },
+
+        // Single synchronous ops
+        "scaled", [](const CImageBuffer& self, int w, int h) {
+            return wrap(scalePixels(*self.pixels(), w, h));
+        },
+        "thumbnail", [](const CImageBuffer& self, int maxW, sol::optional<int> maxH) {
+            return wrap(thumbnailPixels(*self.pixels(), maxW, maxH.value_or(maxW)));
+        },
+        "cropped", [](const CImageBuffer& self, int x, int y, int w, int h) {
+            return wrap(cropPixels(*self.pixels(), x, y, w, h));
+        },
+        "rotated", [](const CImageBuffer& self, double degrees) {
+            return wrap(rotatePixels(*self.pixels(), degrees));
+        },
+        "blurred", [](const CImageBuffer& self, double radius) {
+            return wrap(blurPixels(*self.pixels(), radius));
+        },
+        "grayscale", [](const CImageBuffer& self) {
+            return wrap(colorMatrixPixels(*self.pixels(), grayscaleMatrix()));
+        },
+        "inverted", [](const CImageBuffer& self) {
+            return wrap(colorMatrixPixels(*self.pixels(), invertMatrix()));
+        }
+    );
+
+    lua["ImageBuffer"] = lua.create_table_with(
+        // ImageBuffer.load(path) -> buffer | nil, err
+        "load", [](sol::this_state s, const std::string& path) {
+            std::string error;
+            auto        pixels = loadPixels(path, error);
+            if (!pixels)
+                return std::make_tuple(sol::make_object(s, sol::lua_nil), sol::make_object(s, error));
+            return std::make_tuple(sol::make_object(s, wrap(std::move(*pixels))), sol::make_object(s, sol::lua_nil));
+        },
+
+        // ImageBuffer.loadAsync(path, [ops], function(buffer, err) end)
+        "loadAsync", sol::overload(
+            [](const std::string& path, sol::table ops, sol::protected_function callback) {
+                runAsync(path, parseOps(ops), std::move(callback), "loadAsync");
+            },
+            [](const std::string& path, sol::protected_function callback) {
+                runAsync(path, {}, std::move(callback), "loadAsync");
+            }
+        )
+    );
+
+    // CImageBuilder:buffer(buf) - show a processed buffer. The PNG belongs to the
+    // buffer, keep it referenced while an image shows it.
+    lua["CImageBuilder"]["buffer"] = [](CSharedPointer<CImageBuilder> self, CSharedPointer<CImageBuffer> buffer) {
+        return self->path(std::string(buffer->file()));
+    };
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,270 @@
+#include <sol/sol.hpp>
+#include <hyprtoolkit-lua/LuaAllocator.hpp>
+#include <hyprtoolkit/element/Element.hpp>
+#include <hyprtoolkit/window/Window.hpp>
+#include <cstdio>
+#include <map>
+#include <string>
+
+#include "../helpers/SmartPtrAdapter.hpp"
+#include "../helpers/RefTracker.hpp"
+#include "../helpers/ElementAdapter.hpp"
+
+using namespace Hyprutils::Memory;
+
+namespace Hyprtoolkit::Lua {
+
+struct SRefUsage {
+    size_t refs  = 0;
+    size_t bytes = 0;
+};
+
+// Shallow size estimate of a value on the stack. Tables are not walked
+// recursively, so this is a lower bound for nested data.
+static size_t estimateValueBytes(lua_State* L, int idx) {
+    idx = lua_absindex(L, idx);
+    switch (lua_type(L, idx)) {
+        case LUA_TSTRING: return 24 + lua_rawlen(L, idx) + 1;
+        case LUA_TUSERDATA: return 48 + lua_rawlen(L, idx);
+        case LUA_TFUNCTION: return 40;
+        case LUA_TTHREAD: return 200;
+        case LUA_TTABLE: {
+            size_t entries = 0;
+            lua_pushnil(L);
+            while (lua_next(L, idx) != 0) {
+                ++entries;
+                lua_pop(L, 1);
+            }
+            return 56 + entries * 32;
+        }
+        default: return 0;
+    }
+}
+
+// Estimate what a pinned closure keeps alive: the closure itself plus a shallow
+// size of each upvalue. The globals table is skipped; upvalues shared between
+// closures are counted once per closure. L is the calling thread, which may be a
+// coroutine of the state the ref was pinned in; the stack work happens there.
+static size_t estimateRefBytes(lua_State* L, const SPinnedRef& pinned) {
+    // A coroutine's stack may be small: function, globals, upvalue and a table walk
+    if (!lua_checkstack(L, 5))
+        return 0;
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, pinned.ref);
+    const int fn = lua_gettop(L);
+    if (lua_type(L, fn) != LUA_TFUNCTION) {
+        lua_pop(L, 1);
+        return 0;
+    }
+
+    lua_pushglobaltable(L);
+    const int globals = lua_gettop(L);
+
+    size_t bytes = 32;
+    for (int i = 1; lua_getupvalue(L, fn, i); ++i) {
+        bytes += 16;
+        if (!lua_rawequal(L, -1, globals))
+            bytes += estimateValueBytes(L, -1);
+        lua_pop(L, 1);
+    }
+
+    lua_pop(L, 2);
+    return bytes;
+}
+
+static std::string ownerKey(const void* owner) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%p", owner);
+    return buf;
+}
+
+static size_t heapBytes(lua_State* L) {
+    return static_cast<size_t>(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + static_cast<size_t>(lua_gc(L, LUA_GCCOUNTB, 0));
+}
+
+// Refs pinned in this state, grouped by owner and by usertype
+struct SRefReport {
+    SRefUsage                          total;
+    std::map<std::string, SRefUsage>   usertypes;
+    std::map<const void*, SRefUsage>   owners;
+    std::map<const void*, const char*> ownerTypes;
+};
+
+static SRefReport collectRefs(lua_State* L) {
+    SRefReport report;
+    lua_State* main = sol::main_thread(L, L);
+
+    for (const auto& [id, pinned] : CRefTracker::get().refs()) {
+        if (pinned.state != main)
+            continue;
+
+        const auto bytes = estimateRefBytes(L, pinned);
+
+        report.total.refs++;
+        report.total.bytes += bytes;
+
+        auto& type = report.usertypes[pinned.type ? pinned.type : "?"];
+        type.refs++;
+        type.bytes += bytes;
+
+        auto& owner = report.owners[pinned.owner];
+        owner.refs++;
+        owner.bytes += bytes;
+        report.ownerTypes.emplace(pinned.owner, pinned.type);
+    }
+
+    return report;
+}
+
+static sol::table usageTable(sol::state_view& lua, const SRefUsage& usage) {
+    return lua.create_table_with("refs", usage.refs, "bytes", usage.bytes);
+}
+
+static sol::table makeSnapshot(sol::this_state s) {
+    sol::state_view lua(s);
+    const auto      report    = collectRefs(s);
+    sol::table      usertypes = lua.create_table();
+    for (const auto& [name, usage] : report.usertypes) {
+        usertypes[name] = usageTable(lua, usage);
+    }
+
+    sol::table owners = lua.create_table();
+    for (const auto& [owner, usage] : report.owners) {
+        sol::table entry = usageTable(lua, usage);
+        entry["type"]    = report.ownerTypes.at(owner) ? report.ownerTypes.at(owner) : "?";
+        owners[ownerKey(owner)] = entry;
+    }
+
+    return lua.create_table_with(
+        "heapBytes", heapBytes(s),
+        "refs", report.total.refs,
+        "bytes", report.total.bytes,
+        "usertypes", usertypes,
+        "owners", owners
+    );
+}
+
+// b - a for a pair of snapshot() tables
+static sol::table diffSnapshots(sol::this_state s, sol::table a, sol::table b) {
+    sol::state_view lua(s);
+
+    auto delta = [](sol::table from, sol::table to, const char* key) {
+        return to.get_or<double>(key, 0.0) - from.get_or<double>(key, 0.0);
+    };
+
+    sol::table usertypes = lua.create_table();
+    sol::table before    = a.get_or("usertypes", lua.create_table());
+    sol::table after     = b.get_or("usertypes", lua.create_table());
+
+    auto addUsertypeDelta = [&](const std::string& name) {
+        if (usertypes[name].valid())
+            return;
+        sol::table from  = before.get_or(name, lua.create_table());
+        sol::table to    = after.get_or(name, lua.create_table());
+        const auto refs  = delta(from, to, "refs");
+        const auto bytes = delta(from, to, "bytes");
+        if (refs != 0 || bytes != 0)
+            usertypes[name] = lua.create_table_with("refs", refs, "bytes", bytes);
+    };
+
+    for (const auto& [key, _] : before) {
+        addUsertypeDelta(key.as<std::string>());
+    }
+    for (const auto& [key, _] : after) {
+        addUsertypeDelta(key.as<std::string>());
+    }
+
+    // Owners that appeared or went away between the two snapshots
+    sol::table ownersBefore = a.get_or("owners", lua.create_table());
+    sol::table ownersAfter  = b.get_or("owners", lua.create_table());
+    sol::table added        = lua.create_table();
+    sol::table released     = lua.create_table();
+
+    for (const auto& [key, value] : ownersAfter) {
+        if (!ownersBefore[key].valid())
+            added[key] = value;
+    }
+    for (const auto& [key, value] : ownersBefore) {
+        if (!ownersAfter[key].valid())
+            released[key] = value;
+    }
+
+    return lua.create_table_with(
+        "heapBytes", delta(a, b, "heapBytes"),
+        "refs", delta(a, b, "refs"),
+        "bytes", delta(a, b, "bytes"),
+        "usertypes", usertypes,
+        "added", added,
+        "released", released
+    );
+}
+
+void registerInstrumentation(sol::state& lua) {
+    lua["Instrumentation"] = lua.create_table_with(
+        // Total number of Lua functions pinned by C++ callbacks in this state
+        "refCount", [](sol::this_state s) {
+            return collectRefs(s).total.refs;
+        },
+
+        // Bytes in use by the Lua heap
+        "heapBytes", [](sol::this_state s) {
+            return heapBytes(s);
+        },
+
+        // { [usertype] = { refs = n, bytes = n } }
+        "usertypes", [](sol::this_state s) {
+            sol::state_view lua(s);
+            sol::table      result = lua.create_table();
+            for (const auto& [name, usage] : collectRefs(s).usertypes) {
+                result[name] = usageTable(lua, usage);
+            }
+            return result;
+        },
+
+        // refs, bytes pinned by a single element or window
+        "refsFor", [](sol::this_state s, sol::object obj) {
+            const void* owner = nullptr;
+            if (const auto element = elementFromLua(obj))
+                owner = element.get();
+            else if (obj.is<IWindow>())
+                owner = obj.as<IWindow*>();
+            else
+                throw std::runtime_error("refsFor: argument is not an element or window");
+
+            const auto report = collectRefs(s);
+            const auto it     = report.owners.find(owner);
+            if (it == report.owners.end())
+                return std::make_tuple(size_t{0}, size_t{0});
+            return std::make_tuple(it->second.refs, it->second.bytes);
+        },
+
+        // Pool allocator statistics, nil when the state uses the system allocator
+        "allocator", [](sol::this_state s) -> sol::object {
+            const auto* allocator = CLuaAllocator::fromState(s);
+            if (!allocator)
+                return sol::lua_nil;
+
+            sol::state_view lua(s);
+            const auto      stats   = allocator->stats();
+            sol::table      classes = lua.create_table();
+            for (const auto& cls : stats.sizeClasses) {
+                classes.add(lua.create_table_with("size", cls.size, "inUse", cls.inUse, "free", cls.free));
+            }
+
+            return lua.create_table_with(
+                "bytesInUse", stats.bytesInUse,
+                "peakBytes", stats.peakBytes,
+                "limit", stats.limit,
+                "arenaBytes", stats.arenaBytes,
+                "largeBytes", stats.largeBytes,
+                "failedAllocations", stats.failedAllocations,
+                "sizeClasses", classes
+            );
+        },
+
+        "snapshot", &makeSnapshot,
+        "diff", &diffSnapshots
+    );
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,527 @@
+#include <sol/sol.hpp>
+#include <hyprtoolkit/core/Backend.hpp>
+#include <hyprtoolkit/core/Timer.hpp>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "../helpers/SmartPtrAdapter.hpp"
+#include "../helpers/CallbackAdapter.hpp"
+#include "../helpers/RefTracker.hpp"
+#include "../helpers/Async.hpp"
+
+extern char** environ;
+
+using namespace Hyprutils::Memory;
+
+namespace Hyprtoolkit::Lua {
+
+struct SSpawnOptions {
+    std::vector<std::string>           argv;
+    std::map<std::string, std::string> env;
+    std::vector<std::string>           unsetEnv;
+    bool                               clearEnv = false;
+    std::string                        cwd;
+    bool                               lines     = false;
+    int                                timeoutMs = 0;
+};
+
+// A child process whose pipes and pidfd are watched by the backend loop.
+// onExit runs once the child has exited and both output pipes hit EOF, so no
+// output is delivered after it.
+class CProcess {
+  public:
+    ~CProcess() {
+        for (auto& stream : m_streams) {
+            if (stream.fd >= 0)
+                close(stream.fd);
+        }
+        if (m_stdin >= 0)
+            close(m_stdin);
+        if (m_pidfd >= 0)
+            close(m_pidfd);
+    }
+
+    int pid() const {
+        return m_pid;
+    }
+
+    bool running() const {
+        return !m_exited;
+    }
+
+    bool timedOut() const {
+        return m_timedOut;
+    }
+
+    std::optional<int> exitCode() const {
+        return m_exitCode;
+    }
+
+    bool kill(std::optional<int> sig) {
+        if (m_exited)
+            return false;
+        if (m_pidfd >= 0)
+            return syscall(SYS_pidfd_send_signal, m_pidfd, sig.value_or(SIGTERM), nullptr, 0) == 0;
+        return ::kill(m_pid, sig.value_or(SIGTERM)) == 0;
+    }
+
+    // Queues data for the child's stdin; what the pipe can't take right away is
+    // retried from a short timer instead of blocking the loop
+    bool write(const std::string& data) {
+        if (m_stdin < 0 || m_closeStdinWhenFlushed)
+            return false;
+        m_stdinBuffer += data;
+        flushStdin();
+        return true;
+    }
+
+    void closeStdin() {
+        m_closeStdinWhenFlushed = true;
+        flushStdin();
+    }
+
+    struct SStream {
+        int                            fd = -1;
+        std::string                    partial; // line mode: text after the last newline
+        std::optional<CLuaFunctionRef> callback;
+        const char*                    label = "";
+    };
+
+    void                           readStream(SStream& stream);
+    void                           onExited();
+    void                           maybeFinish();
+    void                           flushStdin();
+
+    int                            m_pid   = -1;
+    int                            m_pidfd = -1;
+    int                            m_stdin = -1;
+    SStream                        m_streams[2];
+    bool                           m_lines = false;
+    std::optional<CLuaFunctionRef> m_onExit;
+    CAtomicSharedPointer<CTimer>   m_timeout;
+
+    std::string                    m_stdinBuffer;
+    bool                           m_closeStdinWhenFlushed = false;
+    bool                           m_stdinTimerArmed       = false;
+
+    std::optional<int>             m_exitCode;
+    std::optional<int>             m_signal;
+    bool                           m_exited   = false;
+    bool                           m_timedOut = false;
+    bool                           m_finished = false;
+};
+
+// Processes stay alive here until onExit has run, even if Lua drops the handle.
+// Leaked, like the fs operations, so no callback ref is released after lua_close.
+static auto* liveProcesses = new std::unordered_set<CSharedPointer<CProcess>>();
+
+static CSharedPointer<CProcess> findLive(CProcess* process) {
+    for (const auto& p : *liveProcesses) {
+        if (p.get() == process)
+            return p;
+    }
+    return nullptr;
+}
+
+// Watches a fd until the callback asks to stop. Removing a fd is deferred to an idle
+// callback so it never happens from inside that fd's own dispatch.
+static void unwatchFd(int& fd) {
+    if (fd < 0)
+        return;
+
+    if (auto backend = CMainQueue::get().backend()) {
+        backend->addIdle([backend, fd]() {
+            backend->removeFd(fd);
+            close(fd);
+        });
+    } else
+        close(fd);
+    fd = -1;
+}
+
+void CProcess::readStream(SStream& stream) {
+    if (stream.fd < 0)
+        return;
+
+    // Keep this process alive for the duration of the Lua callbacks
+    auto self = findLive(this);
+
+    // Bounded per dispatch so a chatty child can't starve the loop; the fd is
+    // still readable afterwards and gets dispatched again
+    char buf[16384];
+    for (int reads = 0; reads < 16; ++reads) {
+        const ssize_t n = read(stream.fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+
+        if (n <= 0) {
+            // EOF or a hard error: flush an unterminated last line and stop watching
+            if (m_lines && !stream.partial.empty() && stream.callback)
+                invokeLuaCallback(*stream.callback, stream.label, std::exchange(stream.partial, {}));
+            unwatchFd(stream.fd);
+            maybeFinish();
+            return;
+        }
+
+        if (!stream.callback)
+            continue;
+
+        if (!m_lines) {
+            invokeLuaCallback(*stream.callback, stream.label, std::string_view(buf, n));
+            continue;
+        }
+
+        stream.partial.append(buf, n);
+        size_t start = 0;
+        for (size_t nl = stream.partial.find('\n'); nl != std::string::npos; nl = stream.partial.find('\n', start)) {
+            invokeLuaCallback(*stream.callback, stream.label, std::string_view(stream.partial).substr(start, nl - start));
+            start = nl + 1;
+        }
+        stream.partial.erase(0, start);
+    }
+}
+
+// Reaps the child if it has exited. Called when the pidfd becomes readable, or
+// from a poll timer on kernels without pidfd.
+void CProcess::onExited() {
+    if (m_exited)
+        return;
+
+    siginfo_t info = {};
+    if (waitid(P_PID, m_pid, &info, WEXITED | WNOHANG) != 0 || info.si_pid == 0)
+        return;
+
+    m_exited = true;
+    if (info.si_code == CLD_EXITED)
+        m_exitCode = info.si_status;
+    else
+        m_signal = info.si_status;
+
+    if (m_timeout)
+        m_timeout->cancel();
+    unwatchFd(m_pidfd);
+    maybeFinish();
+}
+
+void CProcess::maybeFinish() {
+    if (m_finished || !m_exited || m_streams[0].fd >= 0 || m_streams[1].fd >= 0)
+        return;
+
+    m_finished = true;
+    if (m_stdin >= 0) {
+        close(m_stdin);
+        m_stdin = -1;
+    }
+
+    auto self = findLive(this);
+    liveProcesses->erase(self);
+
+    // Release every Lua function, they may hold the handle that holds them
+    auto onExit = std::move(m_onExit);
+    m_onExit.reset();
+    m_streams[0].callback.reset();
+    m_streams[1].callback.reset();
+
+    if (!onExit)
+        return;
+
+    invokeLuaCallback(*onExit, "process onExit callback", m_exitCode, m_signal);
+}
+
+// write() that fails with EPIPE instead of raising SIGPIPE, without touching the
+// host's disposition: the signal is blocked around the write, and one it raised is
+// consumed before the mask is restored.
+static ssize_t writeWithoutSigpipe(int fd, const void* data, size_t size) {
+    sigset_t pipeSet, oldMask, pending;
+    sigemptyset(&pipeSet);
+    sigaddset(&pipeSet, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeSet, &oldMask);
+
+    // One already pending belongs to someone else
+    sigpending(&pending);
+    const bool    wasPending = sigismember(&pending, SIGPIPE);
+
+    const ssize_t n   = ::write(fd, data, size);
+    const int     err = errno;
+
+    if (n < 0 && err == EPIPE && !wasPending) {
+        const timespec zero{};
+        sigtimedwait(&pipeSet, nullptr, &zero);
+    }
+
+    pthread_sigmask(SIG_SETMASK, &oldMask, nullptr);
+    errno = err;
+    return n;
+}
+
+void CProcess::flushStdin() {
+    while (m_stdin >= 0 && !m_stdinBuffer.empty()) {
+        const ssize_t n = writeWithoutSigpipe(m_stdin, m_stdinBuffer.data(), m_stdinBuffer.size());
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (n < 0) {
+            // Child closed its end
+            m_stdinBuffer.clear();
+            close(m_stdin);
+            m_stdin = -1;
+            return;
+        }
+        m_stdinBuffer.erase(0, n);
+    }
+
+    if (m_stdin < 0)
+        return;
+
+    if (m_stdinBuffer.empty()) {
+        if (m_closeStdinWhenFlushed) {
+            close(m_stdin);
+            m_stdin = -1;
+        }
+        return;
+    }
+
+    auto backend = CMainQueue::get().backend();
+    if (m_stdinTimerArmed || !backend)
+        return;
+
+    m_stdinTimerArmed = true;
+    backend->addTimer(
+        std::chrono::milliseconds(5),
+        [weak = CWeakPointer<CProcess>(findLive(this))](CAtomicSharedPointer<CTimer>, void*) {
+            if (auto process = weak.lock()) {
+                process->m_stdinTimerArmed = false;
+                process->flushStdin();
+            }
+        },
+        nullptr, false);
+}
+
+static std::vector<std::string> buildEnvironment(const SSpawnOptions& options) {
+    std::map<std::string, std::string> merged;
+    if (!options.clearEnv) {
+        for (char** e = environ; e && *e; ++e) {
+            std::string_view entry(*e);
+            const auto       eq = entry.find('=');
+            if (eq != std::string_view::npos)
+                merged.emplace(std::string(entry.substr(0, eq)), std::string(entry.substr(eq + 1)));
+        }
+    }
+
+    for (const auto& name : options.unsetEnv) {
+        merged.erase(name);
+    }
+    for (const auto& [name, value] : options.env) {
+        merged[name] = value;
+    }
+
+    std::vector<std::string> env;
+    env.reserve(merged.size());
+    for (const auto& [name, value] : merged) {
+        env.push_back(name + "=" + value);
+    }
+    return env;
+}
+
+// Fallback for kernels without pidfd_open (< 5.3)
+static void pollExit(CWeakPointer<CProcess> weak) {
+    auto backend = CMainQueue::get().backend();
+    if (!backend)
+        return;
+
+    backend->addTimer(
+        std::chrono::milliseconds(50),
+        [weak](CAtomicSharedPointer<CTimer>, void*) {
+            auto process = weak.lock();
+            if (!process)
+                return;
+            process->onExited();
+            if (!process->m_exited)
+                pollExit(weak);
+        },
+        nullptr, false);
+}
+
+static CSharedPointer<CProcess> spawnProcess(const SSpawnOptions& options, sol::table spec) {
+    auto backend = CMainQueue::get().backend();
+    if (!backend)
+        throw std::runtime_error("process.spawn: output is delivered on the backend loop, create a backend first");
+    if (options.argv.empty())
+        throw std::runtime_error("process.spawn: argv must not be empty");
+
+    int in[2], out[2], err[2];
+    if (pipe2(in, O_CLOEXEC) != 0)
+        throw std::runtime_error(std::string("process.spawn: pipe: ") + strerror(errno));
+    if (pipe2(out, O_CLOEXEC) != 0) {
+        close(in[0]), close(in[1]);
+        throw std::runtime_error(std::string("process.spawn: pipe: ") + strerror(errno));
+    }
+    if (pipe2(err, O_CLOEXEC) != 0) {
+        close(in[0]), close(in[1]), close(out[0]), close(out[1]);
+        throw std::runtime_error(std::string("process.spawn: pipe: ") + strerror(errno));
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, in[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, err[1], STDERR_FILENO);
+    if (!options.cwd.empty())
+        posix_spawn_file_actions_addchdir_np(&actions, options.cwd.c_str());
+
+    std::vector<char*> argv;
+    for (const auto& a : options.argv) {
+        argv.push_back(const_cast<char*>(a.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    const auto         envStrings = buildEnvironment(options);
+    std::vector<char*> envp;
+    for (const auto& e : envStrings) {
+        envp.push_back(const_cast<char*>(e.c_str()));
+    }
+    envp.push_back(nullptr);
+
+    // Children start with SIGPIPE at its default, whatever the host set it to
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    sigset_t defaults;
+    sigemptyset(&defaults);
+    sigaddset(&defaults, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attr, &defaults);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF);
+
+    pid_t     pid    = -1;
+    const int result = posix_spawnp(&pid, argv[0], &actions, &attr, argv.data(), envp.data());
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+
+    close(in[0]);
+    close(out[1]);
+    close(err[1]);
+
+    if (result != 0) {
+        close(in[1]), close(out[0]), close(err[0]);
+        throw std::runtime_error("process.spawn: " + options.argv[0] + ": " + strerror(result));
+    }
+
+    auto process                = makeShared<CProcess>();
+    process->m_pid              = pid;
+    process->m_pidfd            = syscall(SYS_pidfd_open, pid, 0);
+    process->m_stdin            = in[1];
+    process->m_lines            = options.lines;
+    process->m_streams[0].fd    = out[0];
+    process->m_streams[0].label = "process onStdout callback";
+    process->m_streams[1].fd    = err[0];
+    process->m_streams[1].label = "process onStderr callback";
+
+    for (int fd : {in[1], out[0], err[0]}) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+
+    if (auto fn = spec.get<sol::object>("onStdout"); fn.is<sol::function>())
+        process->m_streams[0].callback.emplace(fn.as<sol::protected_function>(), process.get(), "CProcess", "onStdout");
+    if (auto fn = spec.get<sol::object>("onStderr"); fn.is<sol::function>())
+        process->m_streams[1].callback.emplace(fn.as<sol::protected_function>(), process.get(), "CProcess", "onStderr");
+    if (auto fn = spec.get<sol::object>("onExit"); fn.is<sol::function>())
+        process->m_onExit.emplace(fn.as<sol::protected_function>(), process.get(), "CProcess", "onExit");
+
+    liveProcesses->insert(process);
+
+    CWeakPointer<CProcess> weak = process;
+    backend->addFd(process->m_streams[0].fd, [weak]() {
+        if (auto p = weak.lock())
+            p->readStream(p->m_streams[0]);
+    });
+    backend->addFd(process->m_streams[1].fd, [weak]() {
+        if (auto p = weak.lock())
+            p->readStream(p->m_streams[1]);
+    });
+
+    if (process->m_pidfd >= 0) {
+        backend->addFd(process->m_pidfd, [weak]() {
+            if (auto p = weak.lock())
+                p->onExited();
+        });
+    } else
+        pollExit(weak);
+
+    if (options.timeoutMs > 0) {
+        process->m_timeout = backend->addTimer(
+            std::chrono::milliseconds(options.timeoutMs),
+            [weak](CAtomicSharedPointer<CTimer>, void*) {
+                if (auto p = weak.lock(); p && p->running()) {
+                    p->m_timedOut = true;
+                    p->kill(SIGKILL);
+                }
+            },
+            nullptr, false);
+    }
+
+    return process;
+}
+
+void registerProcess(sol::state& lua) {
+    lua.new_usertype<CProcess>("CProcess",
+        sol::no_constructor,
+        "pid", &CProcess::pid,
+        "running", &CProcess::running,
+        "timedOut", &CProcess::timedOut,
+        "exitCode", &CProcess::exitCode,
+        "kill", &CProcess::kill,
+        "write", &CProcess::write,
+        "closeStdin", &CProcess::closeStdin
+    );
+
+    lua["process"] = lua.create_table_with(
+        // process.spawn{ argv = { "cmd", ... }, env = { NAME = "value" | false }, clearEnv = bool,
+        //                cwd = "dir", lines = bool, timeout = ms,
+        //                onStdout = fn(data), onStderr = fn(data), onExit = fn(code, signal) }
+        "spawn", [](sol::table spec) {
+            SSpawnOptions options;
+
+            sol::table argv = spec.get<sol::table>("argv");
+            for (size_t i = 1; i <= argv.size(); ++i) {
+                options.argv.push_back(argv[i].get<std::string>());
+            }
+
+            if (auto env = spec.get<sol::object>("env"); env.is<sol::table>()) {
+                for (const auto& [name, value] : env.as<sol::table>()) {
+                    if (value.get_type() == sol::type::boolean && !value.as<bool>())
+                        options.unsetEnv.push_back(name.as<std::string>());
+                    else
+                        options.env[name.as<std::string>()] = value.as<std::string>();
+                }
+            }
+
+            options.clearEnv  = spec.get_or("clearEnv", false);
+            options.cwd       = spec.get_or<std::string>("cwd", "");
+            options.lines     = spec.get_or("lines", false);
+            options.timeoutMs = spec.get_or("timeout", 0);
+
+            return spawnProcess(options, spec);
+        }
+    );
+
+    lua["process"]["SIGTERM"] = SIGTERM;
+    lua["process"]["SIGKILL"] = SIGKILL;
+    lua["process"]["SIGINT"]  = SIGINT;
+    lua["process"]["SIGHUP"]  = SIGHUP;
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,43 @@
+#include <sol/sol.hpp>
+
+#include "../helpers/SmartPtrAdapter.hpp"
+#include "../helpers/Reconciler.hpp"
+
+using namespace Hyprutils::Memory;
+
+namespace Hyprtoolkit::Lua {
+
+void registerReconciler(sol::state& lua) {
+    lua.new_usertype<CReconciler>("CReconciler",
+        sol::no_constructor,
+
+        // view:render({ type = "CText", key = "clock", props = { text = t }, children = { ... } })
+        // or a list of such descriptions; describe the whole view, only changes reach the elements
+        "render", &CReconciler::render,
+        "clear", &CReconciler::clear,
+
+        // view:find("sidebar", "clock") -> element rendered under that key path
+        "find", &CReconciler::find,
+
+        // What the last render did: { created, updated, removed, moved, unchanged }
+        "stats", [](const CReconciler& self, sol::this_state s) {
+            const auto& stats = self.stats();
+            return sol::state_view(s).create_table_with(
+                "created", stats.created,
+                "updated", stats.updated,
+                "removed", stats.removed,
+                "moved", stats.moved,
+                "unchanged", stats.unchanged
+            );
+        }
+    );
+
+    lua["Reconciler"] = lua.create_table_with(
+        // Reconciler.create(container) - the view owns the container's children from now on
+        "create", [](sol::object container) {
+            return makeShared<CReconciler>(std::move(container));
+        }
+    );
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,339 @@
+#include <sol/sol.hpp>
+#include <hyprtoolkit/core/Backend.hpp>
+#include <hyprtoolkit/core/Timer.hpp>
+#include <hyprtoolkit/core/Output.hpp>
+#include <hyprtoolkit-lua/ErrorLog.hpp>
+#include <hyprtoolkit-lua/Tracer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../helpers/SmartPtrAdapter.hpp"
+#include "../helpers/CallbackAdapter.hpp"
+#include "../helpers/RefTracker.hpp"
+#include "../helpers/Async.hpp"
+
+using namespace Hyprutils::Memory;
+
+namespace Hyprtoolkit::Lua {
+
+enum eTaskStatus : uint8_t {
+    TASK_PENDING = 0,
+    TASK_SUSPENDED,
+    TASK_RUNNING,
+    TASK_DONE,
+    TASK_FAILED,
+    TASK_CANCELLED,
+};
+
+// A coroutine run in slices by CTaskScheduler
+class CTask {
+  public:
+    void cancel() {
+        if (m_status <= TASK_RUNNING)
+            m_status = TASK_CANCELLED;
+        m_onDone.reset();
+        m_onError.reset();
+    }
+
+    const char* status() const {
+        switch (m_status) {
+            case TASK_PENDING: return "pending";
+            case TASK_SUSPENDED: return "suspended";
+            case TASK_RUNNING: return "running";
+            case TASK_DONE: return "done";
+            case TASK_FAILED: return "failed";
+            case TASK_CANCELLED: return "cancelled";
+        }
+        return "unknown";
+    }
+
+    bool finished() const {
+        return m_status > TASK_RUNNING;
+    }
+
+    double progress() const {
+        return m_progress;
+    }
+
+    // Milliseconds spent inside the task, excluding time between slices
+    double runTime() const {
+        return m_runTime.count() / 1000.0;
+    }
+
+    uint64_t slices() const {
+        return m_slices;
+    }
+
+    // Items per second of run time, from the counts passed to Tasks.progress
+    double throughput() const {
+        return m_runTime.count() > 0 ? m_items * 1e6 / m_runTime.count() : 0;
+    }
+
+    std::string                    m_name;
+    int                            m_priority = 0;
+    sol::thread                    m_thread;
+    lua_State*                     m_co       = nullptr;
+    std::optional<CLuaFunctionRef> m_onDone;
+    std::optional<CLuaFunctionRef> m_onError;
+    eTaskStatus                    m_status   = TASK_PENDING;
+    double                         m_progress = 0;
+    uint64_t                       m_items    = 0;
+    uint64_t                       m_slices   = 0;
+    uint64_t                       m_lastRun  = 0; // slice counter, for round robin within a priority
+    std::chrono::microseconds      m_runTime{0};
+};
+
+// Resumes tasks once per frame, highest priority first, until the frame's budget is
+// spent. A count hook on each task's coroutine yields it as soon as the budget runs
+// out, so a task written as one long loop still spreads across frames. The hook
+// replaces the watchdog's on task threads: tasks are meant to run long, the budget
+// keeps them in check instead.
+class CTaskScheduler {
+  public:
+    // Leaked like the async singletons: tasks hold their threads and onDone/onError
+    // refs, which must not be released after the state is closed at exit
+    static CTaskScheduler& get() {
+        static auto* scheduler = new CTaskScheduler();
+        return *scheduler;
+    }
+
+    CSharedPointer<CTask> spawn(sol::this_state s, sol::protected_function fn, const sol::optional<sol::table>& options) {
+        auto backend = CMainQueue::get().backend();
+        if (!backend)
+            throw std::runtime_error("Tasks.spawn: no backend loop, create one with IBackend.create() first");
+
+        sol::state_view lua(s);
+        auto            task = makeShared<CTask>();
+        task->m_thread       = sol::thread::create(lua);
+        task->m_co           = task->m_thread.thread_state();
+
+        if (options) {
+            task->m_name     = options->get_or<std::string>("name", "");
+            task->m_priority = options->get_or("priority", 0);
+            if (auto onDone = options->get<sol::optional<sol::protected_function>>("onDone"))
+                task->m_onDone.emplace(std::move(*onDone), task.get(), "CTask", "onDone");
+            if (auto onError = options->get<sol::optional<sol::protected_function>>("onError"))
+                task->m_onError.emplace(std::move(*onError), task.get(), "CTask", "onError");
+        }
+
+        fn.push(task->m_co);
+#ifndef HYPRTOOLKIT_LUA_LUAJIT
+        // LuaJIT can't yield from hooks; there tasks only yield through Tasks.yield()
+        lua_sethook(task->m_co, &CTaskScheduler::hook, LUA_MASKCOUNT, HOOK_INTERVAL);
+#endif
+
+        m_tasks.push_back(task);
+        schedule(backend);
+        return task;
+    }
+
+    // Called from inside a task
+    void progress(double fraction, sol::optional<uint64_t> items) {
+        if (!m_current)
+            throw std::runtime_error("Tasks.progress: not called from a task");
+        m_current->m_progress = std::clamp(fraction, 0.0, 1.0);
+        if (items)
+            m_current->m_items = *items;
+    }
+
+    CSharedPointer<CTask> current() const {
+        return m_current;
+    }
+
+    void setBudget(double ms) {
+        m_budget = std::chrono::microseconds(static_cast<int64_t>(std::max(0.1, ms) * 1000));
+    }
+
+    double budget() const {
+        return m_budget.count() / 1000.0;
+    }
+
+    size_t count() const {
+        return m_tasks.size();
+    }
+
+    // Milliseconds used by the last frame's slice
+    double lastSliceTime() const {
+        return m_lastSlice.count() / 1000.0;
+    }
+
+  private:
+#ifndef HYPRTOOLKIT_LUA_LUAJIT
+    static constexpr int HOOK_INTERVAL = 1000;
+
+    // Coroutines started inside a task inherit the hook, only the task's own is yielded
+    static void hook(lua_State* L, lua_Debug*) {
+        auto& self = get();
+        if (self.m_current && L == self.m_current->m_co && lua_isyieldable(L) && std::chrono::steady_clock::now() >= self.m_deadline)
+            lua_yield(L, 0);
+    }
+#endif
+
+    // Slices run from a timer at the fastest output's frame interval rather than from
+    // addIdle. An idle callback queued from an idle callback runs on the very next loop
+    // iteration, so rescheduling from the slice would spin the loop and hand tasks every
+    // spare moment instead of one budget per frame.
+    void schedule(const CSharedPointer<IBackend>& backend) {
+        // A slice pending on a backend that has since been destroyed never runs
+        if (!m_timerBackend.expired() || m_tasks.empty())
+            return;
+
+        uint32_t fps = 0;
+        for (const auto& output : backend->getOutputs()) {
+            fps = std::max<uint32_t>(fps, output->fps());
+        }
+
+        m_timerBackend = backend;
+        backend->addTimer(std::chrono::milliseconds(std::max(1, static_cast<int>(1000 / (fps ? fps : 60)))),
+                          [](CAtomicSharedPointer<CTimer>, void*) { CTaskScheduler::get().runSlice(); }, nullptr, false);
+    }
+
+    CSharedPointer<CTask> next() {
+        std::erase_if(m_tasks, [](const auto& task) { return task->finished(); });
+
+        CSharedPointer<CTask> best;
+        for (const auto& task : m_tasks) {
+            if (!best || task->m_priority > best->m_priority || (task->m_priority == best->m_priority && task->m_lastRun < best->m_lastRun))
+                best = task;
+        }
+        return best;
+    }
+
+    void runSlice() {
+        m_timerBackend.reset();
+
+        CTracer::CSpan span("tasks", "tasks");
+        const auto     start = std::chrono::steady_clock::now();
+        m_deadline           = start + m_budget;
+
+        while (std::chrono::steady_clock::now() < m_deadline) {
+            auto task = next();
+            if (!task)
+                break;
+            resume(task);
+        }
+
+        m_lastSlice = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        if (auto backend = CMainQueue::get().backend())
+            schedule(backend);
+    }
+
+    void resume(const CSharedPointer<CTask>& task) {
+        const auto started = std::chrono::steady_clock::now();
+        m_current          = task;
+        task->m_status     = TASK_RUNNING;
+        task->m_lastRun    = ++m_sliceCounter;
+        ++task->m_slices;
+
+        int nresults = 0;
+#ifdef HYPRTOOLKIT_LUA_LUAJIT
+        const int status = lua_resume(task->m_co, 0);
+        nresults         = lua_gettop(task->m_co);
+#else
+        const int status = lua_resume(task->m_co, nullptr, 0, &nresults);
+#endif
+
+        m_current = nullptr;
+        task->m_runTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+
+        if (task->m_status == TASK_CANCELLED) {
+            lua_settop(task->m_co, 0);
+            return;
+        }
+
+        if (status == LUA_YIELD) {
+            lua_pop(task->m_co, nresults);
+            task->m_status = TASK_SUSPENDED;
+            return;
+        }
+
+        // Release both functions before calling one, they may hold the task
+        auto onDone  = std::move(task->m_onDone);
+        auto onError = std::move(task->m_onError);
+        task->m_onDone.reset();
+        task->m_onError.reset();
+
+        if (status == LUA_OK) {
+            task->m_status   = TASK_DONE;
+            task->m_progress = 1;
+            sol::object result =
+                nresults > 0 ? sol::stack::get<sol::object>(task->m_co, -nresults) : sol::make_object(task->m_co, sol::lua_nil);
+            lua_settop(task->m_co, 0);
+            if (onDone)
+                invokeLuaCallback(*onDone, "task onDone callback", result);
+            return;
+        }
+
+        task->m_status          = TASK_FAILED;
+        const char*       msg   = lua_tostring(task->m_co, -1);
+        const std::string error = msg ? msg : "unknown error";
+        lua_settop(task->m_co, 0);
+
+        if (onError)
+            invokeLuaCallback(*onError, "task onError callback", error);
+        else
+            CErrorLog::get().report("task " + (task->m_name.empty() ? std::string("(unnamed)") : task->m_name), error);
+    }
+
+    std::vector<CSharedPointer<CTask>>    m_tasks;
+    CSharedPointer<CTask>                 m_current;
+    std::chrono::microseconds             m_budget{4000};
+    std::chrono::microseconds             m_lastSlice{0};
+    std::chrono::steady_clock::time_point m_deadline;
+    uint64_t                              m_sliceCounter = 0;
+    CWeakPointer<IBackend>                m_timerBackend; // set while a slice is pending on it
+};
+
+void registerTasks(sol::state& lua) {
+    lua.new_usertype<CTask>("CTask",
+        sol::no_constructor,
+        "cancel", &CTask::cancel,
+        "status", &CTask::status,
+        "finished", &CTask::finished,
+        "progress", &CTask::progress,
+        "runTime", &CTask::runTime,
+        "slices", &CTask::slices,
+        "throughput", &CTask::throughput,
+        "name", sol::readonly(&CTask::m_name),
+        "priority", sol::readonly(&CTask::m_priority)
+    );
+
+    lua["Tasks"] = lua.create_table_with(
+        // Tasks.spawn(function() ... end, [{ priority = n, name = s, onDone = fn(result), onError = fn(err) }])
+        "spawn", [](sol::this_state s, sol::protected_function fn, sol::optional<sol::table> options) {
+            return CTaskScheduler::get().spawn(s, std::move(fn), options);
+        },
+
+        // Tasks.progress(fraction, [itemsDone]) from inside a task
+        "progress", [](double fraction, sol::optional<uint64_t> items) {
+            CTaskScheduler::get().progress(fraction, items);
+        },
+        "current", []() {
+            return CTaskScheduler::get().current();
+        },
+
+        // Per-frame budget in milliseconds, 4 by default
+        "setBudget", [](double ms) {
+            CTaskScheduler::get().setBudget(ms);
+        },
+        "budget", []() {
+            return CTaskScheduler::get().budget();
+        },
+        "count", []() {
+            return CTaskScheduler::get().count();
+        },
+        "lastSliceTime", []() {
+            return CTaskScheduler::get().lastSliceTime();
+        }
+    );
+
+    // Explicit yield point, the only one under LuaJIT
+    lua["Tasks"]["yield"] = lua["coroutine"]["yield"];
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,58 @@
+#include <sol/sol.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "../helpers/SmartPtrAdapter.hpp"
+#include "../helpers/TextDocument.hpp"
+
+using namespace Hyprutils::Memory;
+
+namespace Hyprtoolkit::Lua {
+
+void registerTextDocument(sol::state& lua) {
+    lua.new_usertype<CTextDocument>("CTextDocument",
+        sol::no_constructor,
+
+        "length", &CTextDocument::length,
+        "lineCount", &CTextDocument::lineCount,
+        "pieces", &CTextDocument::pieceCount,
+        "text", &CTextDocument::text,
+
+        // doc:sub(i, j) - bytes i..j like string.sub, negative indices count from the end
+        "sub", [](const CTextDocument& self, sol::optional<int64_t> from, sol::optional<int64_t> to) {
+            const auto length = (int64_t)self.length();
+            auto       i      = from.value_or(1);
+            auto       j      = to.value_or(-1);
+            if (i < 0)
+                i = std::max<int64_t>(length + i + 1, 1);
+            else if (i == 0)
+                i = 1;
+            if (j < 0)
+                j = length + j + 1;
+            else if (j > length)
+                j = length;
+            if (i > j)
+                return std::string();
+            return self.sub(i - 1, j - i + 1);
+        },
+
+        // doc:line(n) - line n (1-based) without its newline, nil past the end
+        "line", [](const CTextDocument& self, size_t n) -> sol::optional<std::string> {
+            if (n == 0 || n > self.lineCount())
+                return sol::nullopt;
+            const auto start = self.lineStart(n - 1);
+            const auto end   = n == self.lineCount() ? self.length() : self.lineStart(n) - 1;
+            return self.sub(start, end - start);
+        }
+    );
+
+    lua["TextDocument"] = lua.create_table_with(
+        // TextDocument.new(text) - hand to CTextboxBuilder:document()
+        "new", [](sol::optional<std::string> text) {
+            return makeShared<CTextDocument>(text.value_or(""));
+        }
+    );
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,92 @@
+#include <sol/sol.hpp>
+#include <hyprtoolkit-lua/Tracer.hpp>
+
+namespace Hyprtoolkit::Lua {
+
+// Lua 5.4 has no GC callbacks, so a finalizer-only userdata stands in: each time a
+// cycle collects it, its __gc records the event and the heap size, then plants the
+// next sentinel for the following cycle.
+static char GC_SENTINEL_KEY;
+
+static void plantGcSentinel(lua_State* L);
+
+static int gcSentinelCollected(lua_State* L) {
+    auto& tracer = CTracer::get();
+    if (!tracer.enabled())
+        return 0; // no new sentinel, tracing is off
+
+    const double heapKb = lua_gc(L, LUA_GCCOUNT, 0) + lua_gc(L, LUA_GCCOUNTB, 0) / 1024.0;
+    tracer.instant("gc cycle", "gc");
+    tracer.counter("luaHeapKb", "gc", heapKb);
+
+    plantGcSentinel(L);
+    return 0;
+}
+
+static void plantGcSentinel(lua_State* L) {
+    lua_newuserdata(L, 0); // the 5.1 spelling, LuaJIT has no lua_newuserdatauv
+    if (lua_rawgetp(L, LUA_REGISTRYINDEX, &GC_SENTINEL_KEY) != LUA_TTABLE) {
+        lua_pop(L, 1);
+        lua_createtable(L, 0, 1);
+        lua_pushcfunction(L, gcSentinelCollected);
+        lua_setfield(L, -2, "__gc");
+        lua_pushvalue(L, -1);
+        lua_rawsetp(L, LUA_REGISTRYINDEX, &GC_SENTINEL_KEY);
+    }
+    lua_setmetatable(L, -2);
+    lua_pop(L, 1); // unreferenced, collected by the next cycle
+}
+
+static void startTracing(lua_State* L, size_t capacity) {
+    const bool wasEnabled = CTracer::get().enabled();
+    CTracer::get().enable(capacity);
+    if (!wasEnabled)
+        plantGcSentinel(L);
+}
+
+void registerTrace(sol::state& lua) {
+    // The host may have enabled tracing before the state existed (runner --trace)
+    if (CTracer::get().enabled())
+        plantGcSentinel(lua.lua_state());
+
+    lua["Trace"] = lua.create_table_with(
+        // Trace.start([capacity]) - capacity is the ring size in events
+        "start", [](sol::this_state s, sol::optional<size_t> capacity) {
+            startTracing(s, capacity.value_or(1 << 16));
+        },
+        "stop", []() {
+            CTracer::get().disable();
+        },
+        "enabled", []() {
+            return CTracer::get().enabled();
+        },
+        "clear", []() {
+            CTracer::get().clear();
+        },
+
+        // Instant event on the timeline, e.g. Trace.mark("image loaded")
+        "mark", [](const std::string& name) {
+            auto& tracer = CTracer::get();
+            if (tracer.enabled())
+                tracer.instant(tracer.intern(name), "script");
+        },
+
+        // Events in the buffer and events lost to wrap-around
+        "size", []() {
+            return CTracer::get().size();
+        },
+        "dropped", []() {
+            return CTracer::get().dropped();
+        },
+
+        // Writes Chrome trace-event JSON, returns ok
+        "save", [](const std::string& path) {
+            return CTracer::get().save(path);
+        },
+        "json", []() {
+            return CTracer::get().json();
+        }
+    );
+}
+
+} // namespace Hyprtoolkit::Lua
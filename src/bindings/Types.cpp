@@ -8,6 +8,7 @@
 #include <hyprtoolkit/core/Input.hpp>
 
 #include "../helpers/SmartPtrAdapter.hpp"
+#include "../helpers/ColorToken.hpp"
 
 using namespace Hyprutils::Math;
 using namespace Hyprutils::Memory;
@@ -259,6 +260,26 @@ void registerPalette(sol::state& lua) {
         "fontFamily", sol::property([](CPalette& p) { return p.m_vars.fontFamily; }),
         "fontFamilyMonospace", sol::property([](CPalette& p) { return p.m_vars.fontFamilyMonospace; })
     );
+
+    // Palette tokens, usable anywhere a color is accepted
+    lua.new_usertype<CColorToken>("CColorToken",
+        sol::no_constructor,
+        "resolve", &CColorToken::resolve
+    );
+
+    lua["Color"] = lua.create_table_with(
+        // Color.token("accent", { alpha = 0.5, darken = 0.1, brighten = 0.2 })
+        "token", [](const std::string& name, sol::optional<sol::table> options) {
+            std::optional<float> alpha;
+            float                darken = 0, brighten = 0;
+            if (options) {
+                alpha    = options->get<std::optional<float>>("alpha");
+                darken   = options->get_or("darken", 0.f);
+                brighten = options->get_or("brighten", 0.f);
+            }
+            return CColorToken(CColorToken::colorFromName(name), alpha, darken, brighten);
+        }
+    );
 }
 
 // Main registration function for all types
@@ -0,0 +1,46 @@
+#include <sol/sol.hpp>
+#include <hyprtoolkit-lua/Watchdog.hpp>
+
+namespace Hyprtoolkit::Lua {
+
+void registerWatchdog(sol::state& lua) {
+    lua["Watchdog"] = lua.create_table_with(
+        // Whether the host installed a watchdog on this state
+        "enabled", [](sol::this_state s) {
+            return CWatchdog::fromState(s) != nullptr;
+        },
+
+        // Per-callback wall-clock budget in milliseconds, 0 when disabled
+        "budgetMs", [](sol::this_state s) {
+            const auto* watchdog = CWatchdog::fromState(s);
+            return watchdog ? watchdog->options().timeBudget.count() : 0;
+        },
+
+        // { { callback, source, traceback, elapsedMs, instructions }, ... } oldest first
+        "violations", [](sol::this_state s) {
+            sol::state_view lua(s);
+            sol::table      result   = lua.create_table();
+            const auto*     watchdog = CWatchdog::fromState(s);
+            if (!watchdog)
+                return result;
+
+            for (const auto& v : watchdog->violations()) {
+                result.add(lua.create_table_with(
+                    "callback", v.callback,
+                    "source", v.source,
+                    "traceback", v.traceback,
+                    "elapsedMs", v.elapsed.count() / 1000.0,
+                    "instructions", v.instructions
+                ));
+            }
+            return result;
+        },
+
+        "clear", [](sol::this_state s) {
+            if (auto* watchdog = CWatchdog::fromState(s))
+                watchdog->clearViolations();
+        }
+    );
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -5,12 +5,33 @@
 
 #include "../helpers/SmartPtrAdapter.hpp"
 #include "../helpers/CallbackAdapter.hpp"
+#include "../helpers/KeyChords.hpp"
+
+#include <unordered_map>
 
 using namespace Hyprutils::Memory;
 using namespace Hyprutils::Math;
 
 namespace Hyprtoolkit::Lua {
 
+// The chord trie of a window, created on first bindKeys. The keyboardKey listener owns
+// it; the map only finds it again for later calls and expires with the window.
+static CSharedPointer<CKeyChordTrie> keyBindingsFor(IWindow* window) {
+    static std::unordered_map<IWindow*, CWeakPointer<CKeyChordTrie>> bindings;
+
+    if (auto it = bindings.find(window); it != bindings.end()) {
+        if (auto trie = it->second.lock())
+            return trie;
+    }
+
+    std::erase_if(bindings, [](const auto& entry) { return entry.second.expired(); });
+
+    auto trie = makeShared<CKeyChordTrie>(window);
+    window->m_events.keyboardKey.listenStatic([trie](Input::SKeyboardKeyEvent event) { trie->dispatch(event); });
+    bindings[window] = trie;
+    return trie;
+}
+
 void registerWindow(sol::state& lua) {
     // Window type enum
     lua.new_enum<eWindowType>("WindowType",
@@ -66,48 +87,40 @@ void registerWindow(sol::state& lua) {
 
         // Event listeners - we expose them as methods that accept callbacks
         "onResized", [](IWindow* self, sol::function fn) {
-            self->m_events.resized.listenStatic([fn](Vector2D size) {
-                sol::protected_function_result result = fn(size);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Window resized callback error: %s\n", err.what());
-                }
+            self->m_events.resized.listenStatic([ref = CLuaFunctionRef(fn, self, "IWindow", "onResized")](Vector2D size) {
+                invokeLuaCallback(ref, "Window resized callback", size);
             });
         },
         "onCloseRequest", [](IWindow* self, sol::function fn) {
-            self->m_events.closeRequest.listenStatic([fn]() {
-                sol::protected_function_result result = fn();
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Window closeRequest callback error: %s\n", err.what());
-                }
+            self->m_events.closeRequest.listenStatic([ref = CLuaFunctionRef(fn, self, "IWindow", "onCloseRequest")]() {
+                invokeLuaCallback(ref, "Window closeRequest callback");
             });
         },
         "onPopupClosed", [](IWindow* self, sol::function fn) {
-            self->m_events.popupClosed.listenStatic([fn]() {
-                sol::protected_function_result result = fn();
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Window popupClosed callback error: %s\n", err.what());
-                }
+            self->m_events.popupClosed.listenStatic([ref = CLuaFunctionRef(fn, self, "IWindow", "onPopupClosed")]() {
+                invokeLuaCallback(ref, "Window popupClosed callback");
             });
         },
         "onLayerClosed", [](IWindow* self, sol::function fn) {
-            self->m_events.layerClosed.listenStatic([fn]() {
-                sol::protected_function_result result = fn();
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Window layerClosed callback error: %s\n", err.what());
-                }
+            self->m_events.layerClosed.listenStatic([ref = CLuaFunctionRef(fn, self, "IWindow", "onLayerClosed")]() {
+                invokeLuaCallback(ref, "Window layerClosed callback");
             });
         },
+        // Native shortcuts: { ["ctrl+shift+p"] = fn, ["ctrl+k ctrl+s"] = fn, ["escape"] = false }.
+        // Only matched chords enter Lua; the handler gets the chord string. false unbinds.
+        "bindKeys", [](IWindow* self, sol::table keys) {
+            auto trie = keyBindingsFor(self);
+            for (const auto& [key, value] : keys) {
+                const auto chord = key.as<std::string>();
+                if (value.is<sol::function>())
+                    trie->bind(chord, value.as<sol::protected_function>());
+                else
+                    trie->unbind(chord);
+            }
+        },
         "onKeyboardKey", [](IWindow* self, sol::function fn) {
-            self->m_events.keyboardKey.listenStatic([fn](Input::SKeyboardKeyEvent event) {
-                sol::protected_function_result result = fn(event);
-                if (!result.valid()) {
-                    sol::error err = result;
-                    fprintf(stderr, "[Lua] Window keyboardKey callback error: %s\n", err.what());
-                }
+            self->m_events.keyboardKey.listenStatic([ref = CLuaFunctionRef(fn, self, "IWindow", "onKeyboardKey")](Input::SKeyboardKeyEvent event) {
+                invokeLuaCallback(ref, "Window keyboardKey callback", event);
             });
         }
     );
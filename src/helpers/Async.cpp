@@ -0,0 +1,106 @@
+#include "Async.hpp"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+
+using namespace Hyprutils::Memory;
+
+namespace Hyprtoolkit::Lua {
+
+// Both singletons are leaked on purpose: workers may still be blocked in a read at
+// exit, and queued completions hold Lua references that must not be released after
+// the state is gone.
+CWorkerPool& CWorkerPool::get() {
+    static auto* pool = new CWorkerPool();
+    return *pool;
+}
+
+CWorkerPool::CWorkerPool() {
+    const size_t count = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, 8);
+    for (size_t i = 0; i < count; ++i) {
+        m_threads.emplace_back([this]() { run(); }).detach();
+    }
+}
+
+void CWorkerPool::submit(std::function<void()> job) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_cv.notify_one();
+}
+
+size_t CWorkerPool::threads() const {
+    return m_threads.size();
+}
+
+void CWorkerPool::run() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(m_mutex);
+            m_cv.wait(lock, [this]() { return !m_jobs.empty(); });
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
+
+CMainQueue& CMainQueue::get() {
+    static auto* queue = new CMainQueue();
+    return *queue;
+}
+
+CMainQueue::CMainQueue() : m_fd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {}
+
+void CMainQueue::attach(CSharedPointer<IBackend> backend) {
+    if (!backend || m_fd < 0 || m_backend.lock() == backend)
+        return;
+
+    m_backend = backend;
+    backend->addFd(m_fd, []() { CMainQueue::get().drain(); });
+
+    // Work posted before the loop existed
+    if (std::lock_guard lock(m_mutex); !m_pending.empty()) {
+        uint64_t one = 1;
+        write(m_fd, &one, sizeof(one));
+    }
+}
+
+bool CMainQueue::attached() const {
+    return !m_backend.expired();
+}
+
+CSharedPointer<IBackend> CMainQueue::backend() const {
+    return m_backend.lock();
+}
+
+void CMainQueue::post(std::function<void()> fn) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_pending.push_back(std::move(fn));
+    }
+
+    uint64_t one = 1;
+    write(m_fd, &one, sizeof(one));
+}
+
+void CMainQueue::drain() {
+    uint64_t count = 0;
+    read(m_fd, &count, sizeof(count));
+
+    std::vector<std::function<void()>> batch;
+    {
+        std::lock_guard lock(m_mutex);
+        batch.swap(m_pending);
+    }
+
+    for (auto& fn : batch) {
+        fn();
+    }
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <hyprtoolkit/core/Backend.hpp>
+#include <hyprutils/memory/SharedPtr.hpp>
+#include <hyprutils/memory/WeakPtr.hpp>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Background work for bindings. Jobs run on CWorkerPool threads and must not touch
+// Lua; they hand their results to CMainQueue, which runs them on the UI thread from
+// an eventfd registered with the backend. Lua callbacks are only ever invoked there.
+
+namespace Hyprtoolkit::Lua {
+
+class CWorkerPool {
+  public:
+    static CWorkerPool& get();
+
+    void   submit(std::function<void()> job);
+    size_t threads() const;
+
+  private:
+    CWorkerPool();
+
+    void                              run();
+
+    std::mutex                        m_mutex;
+    std::condition_variable           m_cv;
+    std::deque<std::function<void()>> m_jobs;
+    std::vector<std::thread>          m_threads;
+};
+
+class CMainQueue {
+  public:
+    static CMainQueue& get();
+
+    // Deliver posted work through this backend's loop. Called for every backend
+    // created from Lua; the latest one wins.
+    void                                        attach(Hyprutils::Memory::CSharedPointer<IBackend> backend);
+    bool                                        attached() const;
+    Hyprutils::Memory::CSharedPointer<IBackend> backend() const;
+
+    // Thread safe
+    void                                        post(std::function<void()> fn);
+
+  private:
+    CMainQueue();
+
+    void                                      drain();
+
+    int                                       m_fd = -1;
+    Hyprutils::Memory::CWeakPointer<IBackend> m_backend;
+    std::mutex                                m_mutex;
+    std::vector<std::function<void()>>        m_pending;
+};
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <sol/sol.hpp>
+#include <hyprtoolkit-lua/Tracer.hpp>
+#include <hyprtoolkit/element/Element.hpp>
+#include <hyprutils/math/Vector2D.hpp>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "SmartPtrAdapter.hpp"
+#include "CallbackAdapter.hpp"
+#include "ColorFnAdapter.hpp"
+#include "RefTracker.hpp"
+#include "Reconciler.hpp"
+
+// Compile-time descriptions of element builders. Each element is one SElementDesc
+// listing its builder setters, events and element methods; registerElementType turns
+// that into the two usertypes. Setter arguments are converted through SLuaArg, so all
+// setters taking e.g. a colorFn or a string list share one conversion path.
+
+namespace Hyprtoolkit::Lua {
+
+// Who a converted argument belongs to, for reference tracking and error reports
+struct SArgContext {
+    const void* owner = nullptr;
+    const char* type  = nullptr;
+    const char* event = nullptr;
+};
+
+// How a setter parameter of type T arrives from Lua and becomes a T
+template <typename T>
+struct SLuaArg {
+    using lua_type = T;
+
+    static T convert(lua_type&& value, const SArgContext&) {
+        return std::move(value);
+    }
+};
+
+template <>
+struct SLuaArg<colorFn> {
+    using lua_type = sol::object;
+
+    static colorFn convert(lua_type&& value, const SArgContext& ctx) {
+        return luaToColorFn(std::move(value), ctx.owner, ctx.type, ctx.event);
+    }
+};
+
+template <>
+struct SLuaArg<std::vector<std::string>> {
+    using lua_type = sol::table;
+
+    static std::vector<std::string> convert(lua_type&& table, const SArgContext&) {
+        std::vector<std::string> items;
+        items.reserve(table.size());
+        for (size_t i = 1; i <= table.size(); ++i) {
+            items.push_back(table[i].get<std::string>());
+        }
+        return items;
+    }
+};
+
+template <>
+struct SLuaArg<std::vector<Hyprutils::Math::Vector2D>> {
+    using lua_type = sol::table;
+
+    static std::vector<Hyprutils::Math::Vector2D> convert(lua_type&& table, const SArgContext&) {
+        std::vector<Hyprutils::Math::Vector2D> points;
+        points.reserve(table.size());
+        for (size_t i = 1; i <= table.size(); ++i) {
+            sol::table pt = table[i];
+            points.push_back(Hyprutils::Math::Vector2D{pt[1].get<double>(), pt[2].get<double>()});
+        }
+        return points;
+    }
+};
+
+// Events: the Lua function is pinned and invoked through invokeLuaCallback
+template <typename... Args>
+struct SLuaArg<std::function<void(Args...)>> {
+    using lua_type = sol::function;
+
+    static std::function<void(Args...)> convert(lua_type&& fn, const SArgContext& ctx) {
+        return [ref = CLuaFunctionRef(std::move(fn), ctx.owner, ctx.type, ctx.event)](Args... args) { invokeLuaCallback(ref, nullptr, args...); };
+    }
+};
+
+template <typename F>
+struct SSetterTraits;
+
+template <typename C, typename R, typename P>
+struct SSetterTraits<R (C::*)(P)> {
+    using builder = C;
+    using param   = std::remove_cvref_t<P>;
+};
+
+// A single-argument builder setter bound under `name`
+template <auto Setter>
+struct SProp {
+    using traits  = SSetterTraits<decltype(Setter)>;
+    using builder = typename traits::builder;
+    using arg     = SLuaArg<typename traits::param>;
+
+    const char* name;
+
+    static auto apply(builder* self, typename arg::lua_type&& value, const SArgContext& ctx) {
+        return (self->*Setter)(arg::convert(std::move(value), ctx));
+    }
+
+    auto bind(const char* type) const {
+        return [type, name = name](Hyprutils::Memory::CSharedPointer<builder> self, typename arg::lua_type value) {
+            return apply(self.get(), std::move(value), SArgContext{self.get(), type, name});
+        };
+    }
+
+    // Convert once, apply to any number of builders
+    static std::function<void(builder*)> freeze(const sol::object& value, const SArgContext& ctx) {
+        auto converted = arg::convert(value.as<typename arg::lua_type>(), ctx);
+        return [converted = std::move(converted)](builder* self) { (self->*Setter)(typename traits::param(converted)); };
+    }
+};
+
+// Anything else bound as-is (member pointers, hand-written lambdas)
+template <typename F>
+struct SMember {
+    const char* name;
+    F           fn;
+};
+
+template <typename Builder, typename Element, typename Props, typename Events, typename BuilderExtras, typename Members>
+struct SElementDesc {
+    using builder = Builder;
+    using element = Element;
+
+    const char*   builderName;
+    const char*   elementName;
+    Props         props;
+    Events        events;
+    BuilderExtras builderExtras;
+    Members       members;
+};
+
+template <typename Builder, typename Element, typename Props, typename Events = std::tuple<>, typename BuilderExtras = std::tuple<>, typename Members = std::tuple<>>
+constexpr auto describeElement(const char* builderName, const char* elementName, Props props, Events events = {}, BuilderExtras builderExtras = {}, Members members = {}) {
+    return SElementDesc<Builder, Element, Props, Events, BuilderExtras, Members>{builderName, elementName, props, events, builderExtras, members};
+}
+
+// The owner refs of a commenced element are attributed to, the same IElement*
+// elementFromLua() resolves to: wrappers (canvas, log view, reflow layouts) use the
+// element they are added to parents through
+template <typename T>
+const void* refOwner(const Hyprutils::Memory::CSharedPointer<T>& element) {
+    if constexpr (std::is_base_of_v<IElement, T>)
+        return static_cast<IElement*>(element.get());
+    else if constexpr (requires { element->element().get(); })
+        return static_cast<IElement*>(element->element().get());
+    else
+        return element.get();
+}
+
+// Commence a builder and hand the Lua references it pinned over to the new element
+template <typename Builder>
+auto commenceTracked(Hyprutils::Memory::CSharedPointer<Builder> self) {
+    auto element = self->commence();
+    CRefTracker::get().retarget(self.get(), refOwner(element));
+    return element;
+}
+
+// Calls fn(prop) for the property or event of desc called name, returns false if there is none
+template <typename Desc, typename F>
+bool withProp(const Desc& desc, const std::string& name, F&& fn) {
+    bool found = false;
+    auto visit = [&](const auto&... prop) { ((!found && name == prop.name ? (fn(prop), found = true) : false), ...); };
+    std::apply(visit, desc.props);
+    std::apply(visit, desc.events);
+    return found;
+}
+
+// Applies every { prop = value } in props to builder, converting each value from Lua
+template <typename Desc>
+void applyProps(const Desc& desc, typename Desc::builder* builder, const sol::table& props, const char* where) {
+    for (const auto& [key, value] : props) {
+        const auto name  = key.as<std::string>();
+        const bool found = withProp(desc, name, [&](const auto& prop) {
+            using lua_type = typename std::remove_cvref_t<decltype(prop)>::arg::lua_type;
+            prop.apply(builder, value.as<lua_type>(), SArgContext{builder, desc.builderName, prop.name});
+        });
+        if (!found)
+            throw std::runtime_error(std::string(where) + ": " + desc.builderName + " has no property '" + name + "'");
+    }
+}
+
+// Frozen property set of one element type. Values are converted from Lua once, in
+// freeze(); instantiate() replays them on a fresh builder in C++ and only converts
+// the overrides it is given.
+template <typename Desc>
+class CPrototype {
+  public:
+    using Builder = typename Desc::builder;
+
+    CPrototype(const Desc& desc, const sol::table& props) : m_desc(desc) {
+        for (const auto& [key, value] : props) {
+            const auto name  = key.as<std::string>();
+            const bool found = withProp(m_desc, name, [&](const auto& prop) {
+                m_frozen.emplace_back(prop.name, prop.freeze(value, SArgContext{this, m_desc.builderName, prop.name}));
+            });
+            if (!found)
+                throw std::runtime_error(std::string("freeze: ") + m_desc.builderName + " has no property '" + name + "'");
+        }
+    }
+
+    auto instantiate(sol::optional<sol::table> overrides) const {
+        // Frozen event callbacks are copied into the builder still owned by the
+        // prototype; those copies belong to the new element
+        const auto firstRef = CRefTracker::get().nextID();
+        auto       builder  = Builder::begin();
+
+        for (const auto& [name, frozen] : m_frozen) {
+            if (!overrides || !(*overrides)[name].valid())
+                frozen(builder.get());
+        }
+
+        if (overrides)
+            applyProps(m_desc, builder.get(), *overrides, "instantiate");
+
+        auto element = commenceTracked(builder);
+        CRefTracker::get().retarget(this, refOwner(element), firstRef);
+        return element;
+    }
+
+    // instantiateMany(n, function(i) return overrides end) or instantiateMany({ overrides, ... })
+    sol::table instantiateMany(sol::this_state s, sol::object countOrList, sol::optional<sol::protected_function> fn) const {
+        sol::state_view lua(s);
+        sol::table      elements = lua.create_table();
+        CTracer::CSpan  span("instantiateMany", "builder", m_desc.builderName);
+
+        if (countOrList.is<sol::table>()) {
+            sol::table list = countOrList;
+            for (size_t i = 1; i <= list.size(); ++i) {
+                elements[i] = instantiate(list.get<sol::optional<sol::table>>(i));
+            }
+            return elements;
+        }
+
+        const auto count = countOrList.as<size_t>();
+        for (size_t i = 1; i <= count; ++i) {
+            if (!fn) {
+                elements[i] = instantiate(sol::nullopt);
+                continue;
+            }
+
+            sol::protected_function_result result = (*fn)(i);
+            if (!result.valid()) {
+                sol::error err = result;
+                throw std::runtime_error(std::string("instantiateMany: ") + err.what());
+            }
+            elements[i] = instantiate(result.get<sol::optional<sol::table>>());
+        }
+        return elements;
+    }
+
+  private:
+    Desc                                                               m_desc;
+    std::vector<std::pair<std::string, std::function<void(Builder*)>>> m_frozen;
+};
+
+// Lets CReconciler create <builderName> elements and, when they have rebuild(),
+// update them in place
+template <typename Desc>
+void registerReconcileType(const Desc& desc) {
+    using Builder = typename Desc::builder;
+    using Element = typename Desc::element;
+
+    SReconcileType type;
+    type.create = [desc](sol::state_view lua, const sol::table& props) {
+        auto builder = Builder::begin();
+        applyProps(desc, builder.get(), props, "render");
+        return sol::make_object(lua, commenceTracked(builder));
+    };
+    if constexpr (requires(Element& e) { e.rebuild(); }) {
+        type.update = [desc](const sol::object& element, const sol::table& props) {
+            auto builder = element.as<Hyprutils::Memory::CSharedPointer<Element>>()->rebuild();
+            applyProps(desc, builder.get(), props, "render");
+            commenceTracked(builder);
+        };
+    }
+    std::apply([&](const auto&... event) { (type.events.insert(event.name), ...); }, desc.events);
+
+    // "CTextBuilder" and "CText"
+    std::string shortName = desc.builderName;
+    if (shortName.ends_with("Builder"))
+        shortName.resize(shortName.size() - 7);
+    reconcileTypes()[desc.builderName] = type;
+    reconcileTypes()[shortName]        = std::move(type);
+}
+
+// Register <builderName> with begin/props/events/commence/freeze, a prototype type
+// for freeze, and <elementName> with rebuild (when the element has one), size and
+// the listed members.
+template <typename Desc>
+void registerElementType(sol::state& lua, const Desc& desc) {
+    using Builder = typename Desc::builder;
+    using Element = typename Desc::element;
+
+    auto builder = lua.new_usertype<Builder>(desc.builderName, sol::no_constructor);
+    builder.set("begin", &Builder::begin);
+    std::apply([&](const auto&... prop) { (builder.set(prop.name, prop.bind(desc.builderName)), ...); }, desc.props);
+    std::apply([&](const auto&... event) { (builder.set(event.name, event.bind(desc.builderName)), ...); }, desc.events);
+    std::apply([&](const auto&... extra) { (builder.set(extra.name, extra.fn), ...); }, desc.builderExtras);
+    builder.set("commence", [name = desc.builderName](Hyprutils::Memory::CSharedPointer<Builder> self) {
+        CTracer::CSpan span("commence", "builder", name);
+        return commenceTracked(self);
+    });
+
+    // <builderName>.freeze{ prop = value, ... } -> prototype
+    lua.new_usertype<CPrototype<Desc>>(std::string(desc.builderName) + "Prototype",
+        sol::no_constructor,
+        "instantiate", &CPrototype<Desc>::instantiate,
+        "instantiateMany", &CPrototype<Desc>::instantiateMany
+    );
+    builder.set("freeze", [desc](sol::table props) { return Hyprutils::Memory::makeShared<CPrototype<Desc>>(desc, props); });
+
+    // Layouts implemented here wrap a container instead of deriving from IElement
+    auto element = [&] {
+        if constexpr (std::is_base_of_v<IElement, Element>)
+            return lua.new_usertype<Element>(desc.elementName, sol::no_constructor, sol::base_classes, sol::bases<IElement>());
+        else
+            return lua.new_usertype<Element>(desc.elementName, sol::no_constructor);
+    }();
+    if constexpr (requires(Element& e) { e.rebuild(); }) {
+        element.set("rebuild", [name = desc.elementName](Element* self) {
+            CTracer::CSpan span("rebuild", "builder", name);
+            return self->rebuild();
+        });
+    }
+    element.set("size", &Element::size);
+    std::apply([&](const auto&... member) { (element.set(member.name, member.fn), ...); }, desc.members);
+
+    registerReconcileType(desc);
+}
+
+} // namespace Hyprtoolkit::Lua
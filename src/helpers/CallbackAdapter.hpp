@@ -1,9 +1,14 @@
 #pragma once
 
 #include <sol/sol.hpp>
+#include <hyprtoolkit-lua/ErrorLog.hpp>
+#include <hyprtoolkit-lua/Tracer.hpp>
+#include <hyprtoolkit-lua/Watchdog.hpp>
 #include <functional>
 #include <string>
 
+#include "RefTracker.hpp"
+
 namespace Hyprtoolkit::Lua {
 
 // Convert a Lua function to a std::function with error handling
@@ -13,8 +18,7 @@ std::function<Ret(Args...)> luaToCallback(sol::protected_function fn) {
         sol::protected_function_result result = fn(args...);
         if (!result.valid()) {
             sol::error err = result;
-            // TODO: integrate with hyprtoolkit logging
-            fprintf(stderr, "[Lua] Callback error: %s\n", err.what());
+            CErrorLog::get().report("Callback", err.what());
             if constexpr (!std::is_void_v<Ret>) {
                 return Ret{};
             }
@@ -33,7 +37,7 @@ std::function<void(Args...)> luaToVoidCallback(sol::protected_function fn) {
         sol::protected_function_result result = fn(args...);
         if (!result.valid()) {
             sol::error err = result;
-            fprintf(stderr, "[Lua] Callback error: %s\n", err.what());
+            CErrorLog::get().report("Callback", err.what());
         }
     };
 }
@@ -46,9 +50,27 @@ auto makeSafeCallback(sol::function fn) {
         sol::protected_function_result result = pfn(args...);
         if (!result.valid()) {
             sol::error err = result;
-            fprintf(stderr, "[Lua] Callback error: %s\n", err.what());
+            CErrorLog::get().report("Callback", err.what());
         }
     };
 }
 
+// Call a pinned Lua callback, reporting errors to CErrorLog under `what`.
+// A null `what` labels the callback by its usertype and event instead.
+// Returns the call's result, invalid if it raised.
+template <typename... Args>
+sol::protected_function_result invokeLuaCallback(const CLuaFunctionRef& fn, const char* what, Args&&... args) {
+    CTracer::CSpan                 span(what ? what : fn.event(), "callback", what ? fn.event() : fn.type());
+    CWatchdog::CScope              watchdog(fn.function().lua_state(), what ? what : fn.type(), what ? nullptr : fn.event());
+    sol::protected_function_result result = fn(std::forward<Args>(args)...);
+    if (!result.valid()) {
+        sol::error err = result;
+        if (what)
+            CErrorLog::get().report(what, err.what());
+        else
+            CErrorLog::get().report(std::string(fn.type()) + "." + fn.event(), err.what());
+    }
+    return result;
+}
+
 } // namespace Hyprtoolkit::Lua
@@ -0,0 +1,382 @@
+#include "Canvas.hpp"
+
+#include <hyprtoolkit/core/Timer.hpp>
+#include <pixman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <unordered_map>
+
+#include <hyprtoolkit-lua/ErrorLog.hpp>
+#include <hyprtoolkit-lua/Tracer.hpp>
+
+#include "Async.hpp"
+#include "RuntimeImage.hpp"
+
+using namespace Hyprutils::Memory;
+using namespace Hyprutils::Math;
+
+namespace Hyprtoolkit::Lua {
+
+// Canvases waiting for a raster, so workers only ever see an id
+static std::unordered_map<uint64_t, CWeakPointer<SCanvasState>> canvases;
+static uint64_t                                                  nextCanvasId = 1;
+
+static uint32_t packColor(const CHyprColor& color) {
+    auto channel = [](double v) { return static_cast<uint32_t>(std::clamp(v, 0.0, 1.0) * 255.0 + 0.5); };
+    return channel(color.a) << 24 | channel(color.r) << 16 | channel(color.g) << 8 | channel(color.b);
+}
+
+static CHyprColor unpackColor(uint32_t argb) {
+    return CHyprColor(((argb >> 16) & 0xFF) / 255.0, ((argb >> 8) & 0xFF) / 255.0, (argb & 0xFF) / 255.0, (argb >> 24) / 255.0);
+}
+
+// pixman wants premultiplied 16 bit channels
+static pixman_color_t pixmanColor(uint32_t argb) {
+    const uint32_t a       = argb >> 24;
+    auto           channel = [a](uint32_t v) { return static_cast<uint16_t>(v * a * 0x101 / 0xFF); };
+    return pixman_color_t{channel((argb >> 16) & 0xFF), channel((argb >> 8) & 0xFF), channel(argb & 0xFF), static_cast<uint16_t>(a * 0x101)};
+}
+
+static pixman_point_fixed_t fixedPoint(double x, double y) {
+    return pixman_point_fixed_t{pixman_double_to_fixed(x), pixman_double_to_fixed(y)};
+}
+
+// A segment as a quad of two triangles
+static void appendSegment(std::vector<pixman_triangle_t>& tris, double x0, double y0, double x1, double y1, double thickness) {
+    const double dx  = x1 - x0;
+    const double dy  = y1 - y0;
+    const double len = std::hypot(dx, dy);
+    if (len <= 0)
+        return;
+
+    const double nx = -dy / len * thickness / 2;
+    const double ny = dx / len * thickness / 2;
+
+    const auto   a = fixedPoint(x0 + nx, y0 + ny);
+    const auto   b = fixedPoint(x1 + nx, y1 + ny);
+    const auto   c = fixedPoint(x1 - nx, y1 - ny);
+    const auto   d = fixedPoint(x0 - nx, y0 - ny);
+    tris.push_back(pixman_triangle_t{a, b, c});
+    tris.push_back(pixman_triangle_t{a, c, d});
+}
+
+// Runs on a worker. Consecutive commands of the same kind and color go to pixman in
+// one call, so a bar chart is a single fill regardless of the bar count.
+static std::vector<uint32_t> rasterize(const SCanvasList& list, int width, int height, double scale) {
+    std::vector<uint32_t> pixels(static_cast<size_t>(width) * height, 0);
+    pixman_image_t*       target = pixman_image_create_bits(PIXMAN_a8r8g8b8, width, height, pixels.data(), width * 4);
+    if (!target)
+        return {};
+
+    std::vector<pixman_rectangle16_t> rects;
+    std::vector<pixman_triangle_t>    tris;
+
+    for (size_t i = 0; i < list.commands.size();) {
+        const auto& run = list.commands[i];
+        size_t      end = i;
+        while (end < list.commands.size() && list.commands[end].op == run.op && list.commands[end].color == run.color) {
+            ++end;
+        }
+
+        const auto color = pixmanColor(run.color);
+        if (run.op == CANVAS_RECT) {
+            rects.clear();
+            for (size_t c = i; c < end; ++c) {
+                const float* v  = &list.coords[list.commands[c].first];
+                const double x0 = std::clamp(std::round(v[0] * scale), -32768.0, 32767.0);
+                const double y0 = std::clamp(std::round(v[1] * scale), -32768.0, 32767.0);
+                const double x1 = std::clamp(std::round((v[0] + v[2]) * scale), -32768.0, 32767.0);
+                const double y1 = std::clamp(std::round((v[1] + v[3]) * scale), -32768.0, 32767.0);
+                if (x1 > x0 && y1 > y0)
+                    rects.push_back(pixman_rectangle16_t{static_cast<int16_t>(x0), static_cast<int16_t>(y0), static_cast<uint16_t>(x1 - x0), static_cast<uint16_t>(y1 - y0)});
+            }
+            if (!rects.empty())
+                pixman_image_fill_rectangles(PIXMAN_OP_OVER, target, &color, rects.size(), rects.data());
+        } else {
+            tris.clear();
+            for (size_t c = i; c < end; ++c) {
+                const auto&  cmd = list.commands[c];
+                const float* v   = &list.coords[cmd.first];
+                for (uint32_t p = 2; p + 1 < cmd.count; p += 2) {
+                    appendSegment(tris, v[p - 2] * scale, v[p - 1] * scale, v[p] * scale, v[p + 1] * scale, cmd.thickness * scale);
+                }
+            }
+            if (!tris.empty()) {
+                pixman_image_t* source = pixman_image_create_solid_fill(&color);
+                pixman_composite_triangles(PIXMAN_OP_OVER, source, target, PIXMAN_a8, 0, 0, 0, 0, tris.size(), tris.data());
+                pixman_image_unref(source);
+            }
+        }
+
+        i = end;
+    }
+
+    pixman_image_unref(target);
+    return pixels;
+}
+
+static CDynamicSize fillParent() {
+    return CDynamicSize(CDynamicSize::HT_SIZE_PERCENT, CDynamicSize::HT_SIZE_PERCENT, {1, 1});
+}
+
+// How long a replaced raster stays underneath its successor, long enough for
+// hyprtoolkit to have decoded the new file so the canvas never shows a blank frame
+static constexpr auto RASTER_SWAP_GRACE = std::chrono::milliseconds(100);
+
+// hyprtoolkit only takes images by path, there is no way to hand a CImageElement a
+// pixel buffer. So a raster is a file, loaded asynchronously to keep the PNG decode
+// off the frame path; the previous raster is dropped once the new one had time to load.
+static void showRaster(const CSharedPointer<SCanvasState>& state, const std::string& path, const Vector2D& size) {
+    auto image = CImageBuilder::begin()->path(std::string(path))->fitMode(IMAGE_FIT_MODE_STRETCH)->size(fillParent())->commence();
+    image->setPositionMode(IElement::HT_POSITION_ABSOLUTE);
+    state->rasterLayer->addChild(image);
+
+    auto backend = CMainQueue::get().backend();
+    if (state->raster && backend) {
+        backend->addTimer(
+            RASTER_SWAP_GRACE,
+            [weak = CWeakPointer<SCanvasState>(state), old = state->raster, oldPath = state->rasterPath](CAtomicSharedPointer<CTimer>, void*) {
+                if (auto state = weak.lock())
+                    state->rasterLayer->removeChild(old);
+                if (!oldPath.empty())
+                    unlink(oldPath.c_str());
+            },
+            nullptr, false);
+    } else {
+        if (state->raster)
+            state->rasterLayer->removeChild(state->raster);
+        if (!state->rasterPath.empty())
+            unlink(state->rasterPath.c_str());
+    }
+
+    state->raster     = image;
+    state->rasterPath = path;
+    state->rasterSize = size;
+}
+
+static void requestRaster(const CSharedPointer<SCanvasState>& state) {
+    auto container = state->container.lock();
+    if (!container)
+        return;
+
+    if (state->rasterizing) {
+        state->dirty = true;
+        return;
+    }
+
+    const Vector2D size   = container->size();
+    const int      width  = static_cast<int>(std::ceil(size.x * state->scale));
+    const int      height = static_cast<int>(std::ceil(size.y * state->scale));
+    if (width <= 0 || height <= 0)
+        return; // not laid out yet, the repositioned callback retries
+
+    state->rasterizing = true;
+    state->dirty       = false;
+
+    const auto id   = state->id;
+    const auto path = runtimeImagePath("canvas", id, ++state->generation);
+    CWorkerPool::get().submit([id, path, size, width, height, scale = state->scale, list = state->committed]() {
+        bool ok = false;
+        {
+            CTracer::CSpan span("rasterize", "canvas");
+            auto           pixels = rasterize(list, width, height, scale);
+            if (!pixels.empty())
+                ok = writeRuntimeImage(path, pixels.data(), width, height);
+        }
+
+        CMainQueue::get().post([id, path, size, ok]() {
+            auto                         it = canvases.find(id);
+            CSharedPointer<SCanvasState> state;
+            if (it != canvases.end())
+                state = it->second.lock();
+            if (!state) {
+                unlink(path.c_str());
+                return;
+            }
+
+            state->rasterizing = false;
+            if (ok)
+                showRaster(state, path, size);
+            else {
+                CErrorLog::get().report("canvas", "failed to write " + path);
+                unlink(path.c_str());
+            }
+
+            if (state->dirty)
+                requestRaster(state);
+        });
+    });
+}
+
+// Pooled overlay elements: reused by index, rebuilt only when their command changed
+static void syncTexts(const CSharedPointer<SCanvasState>& state, const std::vector<SCanvasText>& texts, const std::vector<SCanvasText>& previous) {
+    auto container = state->container.lock();
+
+    for (size_t i = 0; i < texts.size(); ++i) {
+        const auto& t     = texts[i];
+        const bool  fresh = i >= state->textPool.size();
+        if (!fresh && i < previous.size() && previous[i] == t)
+            continue;
+
+        auto builder = fresh ? CTextBuilder::begin() : state->textPool[i]->rebuild();
+        auto element = builder->text(std::string(t.text))->color([color = unpackColor(t.color)]() { return color; })->fontSize(CFontSize(t.fontSize))->commence();
+        element->setPositionMode(IElement::HT_POSITION_ABSOLUTE);
+        element->setAbsolutePosition(t.pos);
+        if (fresh) {
+            container->addChild(element);
+            state->textPool.push_back(element);
+        }
+    }
+
+    while (state->textPool.size() > texts.size()) {
+        container->removeChild(state->textPool.back());
+        state->textPool.pop_back();
+    }
+}
+
+static void syncImages(const CSharedPointer<SCanvasState>& state, const std::vector<SCanvasImage>& images, const std::vector<SCanvasImage>& previous) {
+    auto container = state->container.lock();
+
+    for (size_t i = 0; i < images.size(); ++i) {
+        const auto& img = images[i];
+        if (i < state->imagePool.size() && i < previous.size() && previous[i] == img)
+            continue;
+
+        auto element = CImageBuilder::begin()
+                           ->path(std::string(img.path))
+                           ->fitMode(IMAGE_FIT_MODE_CONTAIN)
+                           ->size(CDynamicSize(CDynamicSize::HT_SIZE_ABSOLUTE, CDynamicSize::HT_SIZE_ABSOLUTE, img.size))
+                           ->commence();
+        element->setPositionMode(IElement::HT_POSITION_ABSOLUTE);
+        element->setAbsolutePosition(img.pos);
+        container->addChild(element);
+
+        if (i < state->imagePool.size()) {
+            container->removeChild(state->imagePool[i]);
+            state->imagePool[i] = element;
+        } else
+            state->imagePool.push_back(element);
+    }
+
+    while (state->imagePool.size() > images.size()) {
+        container->removeChild(state->imagePool.back());
+        state->imagePool.pop_back();
+    }
+}
+
+SCanvasState::~SCanvasState() {
+    canvases.erase(id);
+    if (!rasterPath.empty())
+        unlink(rasterPath.c_str());
+}
+
+CCanvasElement::CCanvasElement(double scale, CDynamicSize&& size) {
+    m_container = CNullBuilder::begin()->size(std::move(size))->commence();
+
+    m_state              = makeShared<SCanvasState>();
+    m_state->id          = nextCanvasId++;
+    m_state->scale       = scale;
+    m_state->container   = CSharedPointer<IElement>(m_container);
+    m_state->rasterLayer = CNullBuilder::begin()->size(fillParent())->commence();
+    m_state->rasterLayer->setPositionMode(IElement::HT_POSITION_ABSOLUTE);
+    m_container->addChild(m_state->rasterLayer);
+    canvases[m_state->id] = m_state;
+
+    // Re-rasterize at the new size on resize
+    m_container->setRepositioned([state = m_state]() {
+        auto container = state->container.lock();
+        if (container && !(container->size() == state->rasterSize))
+            requestRaster(state);
+    });
+}
+
+void CCanvasElement::clear() {
+    m_recording.commands.clear();
+    m_recording.coords.clear();
+    m_recording.texts.clear();
+    m_recording.images.clear();
+}
+
+void CCanvasElement::rect(double x, double y, double w, double h, const CHyprColor& color) {
+    m_recording.commands.push_back(SCanvasCommand{CANVAS_RECT, packColor(color), 0, static_cast<uint32_t>(m_recording.coords.size()), 4});
+    m_recording.coords.insert(m_recording.coords.end(), {static_cast<float>(x), static_cast<float>(y), static_cast<float>(w), static_cast<float>(h)});
+}
+
+void CCanvasElement::line(double x0, double y0, double x1, double y1, const CHyprColor& color, float thickness) {
+    m_recording.commands.push_back(SCanvasCommand{CANVAS_PATH, packColor(color), thickness, static_cast<uint32_t>(m_recording.coords.size()), 4});
+    m_recording.coords.insert(m_recording.coords.end(), {static_cast<float>(x0), static_cast<float>(y0), static_cast<float>(x1), static_cast<float>(y1)});
+}
+
+void CCanvasElement::polyline(const std::vector<Vector2D>& points, const CHyprColor& color, float thickness) {
+    if (points.size() < 2)
+        return;
+
+    m_recording.commands.push_back(SCanvasCommand{CANVAS_PATH, packColor(color), thickness, static_cast<uint32_t>(m_recording.coords.size()), static_cast<uint32_t>(points.size() * 2)});
+    for (const auto& p : points) {
+        m_recording.coords.push_back(static_cast<float>(p.x));
+        m_recording.coords.push_back(static_cast<float>(p.y));
+    }
+}
+
+void CCanvasElement::text(double x, double y, const std::string& text, const CHyprColor& color, const CFontSize& fontSize) {
+    CFontSize size = fontSize;
+    m_recording.texts.push_back(SCanvasText{Vector2D{x, y}, text, packColor(color), size.ptSize(), fontSize});
+}
+
+void CCanvasElement::image(double x, double y, double w, double h, const std::string& path) {
+    m_recording.images.push_back(SCanvasImage{Vector2D{x, y}, Vector2D{w, h}, path});
+}
+
+bool CCanvasElement::commit() {
+    if (m_recording == m_state->committed)
+        return false;
+
+    CTracer::CSpan span("commit", "canvas");
+    const bool     shapesChanged = m_recording.commands != m_state->committed.commands || m_recording.coords != m_state->committed.coords;
+
+    syncTexts(m_state, m_recording.texts, m_state->committed.texts);
+    syncImages(m_state, m_recording.images, m_state->committed.images);
+    m_state->committed = m_recording;
+
+    if (shapesChanged)
+        requestRaster(m_state);
+    else
+        m_container->forceReposition();
+    return true;
+}
+
+size_t CCanvasElement::commandCount() const {
+    return m_recording.commands.size() + m_recording.texts.size() + m_recording.images.size();
+}
+
+Vector2D CCanvasElement::size() {
+    return m_container->size();
+}
+
+CSharedPointer<IElement> CCanvasElement::element() {
+    return CSharedPointer<IElement>(m_container);
+}
+
+CSharedPointer<CCanvasBuilder> CCanvasBuilder::begin() {
+    auto builder    = CSharedPointer<CCanvasBuilder>(new CCanvasBuilder());
+    builder->m_self = builder;
+    return builder;
+}
+
+CSharedPointer<CCanvasBuilder> CCanvasBuilder::scale(double scale) {
+    m_scale = std::max(0.1, scale);
+    return m_self.lock();
+}
+
+CSharedPointer<CCanvasBuilder> CCanvasBuilder::size(CDynamicSize&& size) {
+    m_size = std::move(size);
+    return m_self.lock();
+}
+
+CSharedPointer<CCanvasElement> CCanvasBuilder::commence() {
+    return makeShared<CCanvasElement>(m_scale, m_size.value_or(fillParent()));
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <hyprtoolkit/element/Element.hpp>
+#include <hyprtoolkit/element/Null.hpp>
+#include <hyprtoolkit/element/Text.hpp>
+#include <hyprtoolkit/element/Image.hpp>
+#include <hyprtoolkit/palette/Color.hpp>
+#include <hyprtoolkit/types/FontTypes.hpp>
+#include <hyprtoolkit/types/ImageTypes.hpp>
+#include <hyprtoolkit/types/SizeType.hpp>
+#include <hyprutils/math/Vector2D.hpp>
+#include <hyprutils/memory/SharedPtr.hpp>
+#include <hyprutils/memory/WeakPtr.hpp>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Immediate-mode canvas. Lua records draw calls into a flat command list; commit()
+// compares it with the last committed list and, only if it changed, rasterizes all
+// shapes with pixman in one pass on a worker thread. The result is shown through a
+// single CImageElement, loaded from a runtime file since hyprtoolkit takes no pixel
+// buffers. Text runs and images are pooled child elements on top, so
+// shaping and decoding stay with hyprtoolkit.
+
+namespace Hyprtoolkit::Lua {
+
+enum eCanvasOp : uint8_t {
+    CANVAS_RECT = 0, // coords: x, y, w, h
+    CANVAS_PATH,     // coords: x0, y0, x1, y1, ...
+};
+
+struct SCanvasCommand {
+    eCanvasOp op        = CANVAS_RECT;
+    uint32_t  color     = 0; // ARGB, not premultiplied
+    float     thickness = 1;
+    uint32_t  first     = 0; // into SCanvasList::coords
+    uint32_t  count     = 0;
+
+    bool      operator==(const SCanvasCommand&) const = default;
+};
+
+struct SCanvasText {
+    Hyprutils::Math::Vector2D pos;
+    std::string               text;
+    uint32_t                  color  = 0;
+    float                     ptSize = 0;
+    CFontSize                 fontSize{CFontSize::HT_FONT_TEXT, 1.F};
+
+    bool                      operator==(const SCanvasText& other) const {
+        return pos == other.pos && text == other.text && color == other.color && ptSize == other.ptSize;
+    }
+};
+
+struct SCanvasImage {
+    Hyprutils::Math::Vector2D pos;
+    Hyprutils::Math::Vector2D size;
+    std::string               path;
+
+    bool                      operator==(const SCanvasImage& other) const {
+        return pos == other.pos && size == other.size && path == other.path;
+    }
+};
+
+struct SCanvasList {
+    std::vector<SCanvasCommand> commands;
+    std::vector<float>          coords;
+    std::vector<SCanvasText>    texts;
+    std::vector<SCanvasImage>   images;
+
+    bool                        operator==(const SCanvasList&) const = default;
+};
+
+// Owned by the container's repositioned callback, like the reflow layouts
+struct SCanvasState {
+    ~SCanvasState();
+
+    uint64_t                                                      id    = 0;
+    double                                                        scale = 1;
+    Hyprutils::Memory::CWeakPointer<IElement>                     container;
+    Hyprutils::Memory::CSharedPointer<CNullElement>               rasterLayer;
+    Hyprutils::Memory::CSharedPointer<CImageElement>              raster;
+    std::string                                                   rasterPath;
+    Hyprutils::Math::Vector2D                                     rasterSize;
+    std::vector<Hyprutils::Memory::CSharedPointer<CTextElement>>  textPool;
+    std::vector<Hyprutils::Memory::CSharedPointer<CImageElement>> imagePool;
+
+    SCanvasList                                                   committed;
+    uint64_t                                                      generation  = 0;
+    bool                                                          rasterizing = false;
+    bool                                                          dirty       = false;
+};
+
+class CCanvasElement {
+  public:
+    CCanvasElement(double scale, CDynamicSize&& size);
+
+    // Recording. Coordinates are in logical pixels from the canvas' top left.
+    void                                        clear();
+    void                                        rect(double x, double y, double w, double h, const CHyprColor& color);
+    void                                        line(double x0, double y0, double x1, double y1, const CHyprColor& color, float thickness);
+    void                                        polyline(const std::vector<Hyprutils::Math::Vector2D>& points, const CHyprColor& color, float thickness);
+    void                                        text(double x, double y, const std::string& text, const CHyprColor& color, const CFontSize& fontSize);
+    void                                        image(double x, double y, double w, double h, const std::string& path);
+
+    // Publishes the recorded list; false if it equals the last committed one
+    bool                                        commit();
+    size_t                                      commandCount() const;
+
+    Hyprutils::Math::Vector2D                   size();
+    Hyprutils::Memory::CSharedPointer<IElement> element();
+
+  private:
+    Hyprutils::Memory::CSharedPointer<CNullElement> m_container;
+    Hyprutils::Memory::CSharedPointer<SCanvasState> m_state;
+    SCanvasList                                     m_recording;
+};
+
+class CCanvasBuilder {
+  public:
+    static Hyprutils::Memory::CSharedPointer<CCanvasBuilder> begin();
+
+    // Pixels per logical pixel of the raster, e.g. the output scale
+    Hyprutils::Memory::CSharedPointer<CCanvasBuilder>        scale(double scale);
+    Hyprutils::Memory::CSharedPointer<CCanvasBuilder>        size(CDynamicSize&& size);
+
+    Hyprutils::Memory::CSharedPointer<CCanvasElement>        commence();
+
+  private:
+    Hyprutils::Memory::CWeakPointer<CCanvasBuilder>          m_self;
+    double                                                   m_scale = 1;
+    std::optional<CDynamicSize>                              m_size;
+};
+
+} // namespace Hyprtoolkit::Lua
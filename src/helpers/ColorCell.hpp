@@ -0,0 +1,43 @@
+#pragma once
+
+#include <hyprtoolkit/element/Element.hpp>
+#include <hyprtoolkit/palette/Color.hpp>
+#include <hyprutils/memory/SharedPtr.hpp>
+#include <hyprutils/memory/WeakPtr.hpp>
+#include <vector>
+
+namespace Hyprtoolkit::Lua {
+
+// A mutable color shared between C++ and Lua. Passing a cell where a color is
+// expected binds the element to the cell: its colorFn reads the cell, so a new value
+// shows without a rebuild. Nothing repaints an element on its own when only its
+// colorFn's result changes, so elements to repaint are registered with bind().
+class CColorCell {
+  public:
+    explicit CColorCell(const CHyprColor& color) : m_color(color) {}
+
+    const CHyprColor& get() const {
+        return m_color;
+    }
+
+    // Stores the color and repaints the bound elements
+    void set(const CHyprColor& color) {
+        m_color = color;
+
+        std::erase_if(m_targets, [](const auto& weak) { return weak.expired(); });
+        for (const auto& weak : m_targets) {
+            if (auto element = weak.lock())
+                element->forceReposition();
+        }
+    }
+
+    void bind(const Hyprutils::Memory::CSharedPointer<IElement>& element) {
+        m_targets.emplace_back(element);
+    }
+
+  private:
+    CHyprColor                                             m_color;
+    std::vector<Hyprutils::Memory::CWeakPointer<IElement>> m_targets;
+};
+
+} // namespace Hyprtoolkit::Lua
@@ -1,29 +1,48 @@
 #pragma once
 
 #include <sol/sol.hpp>
+#include <hyprtoolkit-lua/ErrorLog.hpp>
+#include <hyprtoolkit-lua/Tracer.hpp>
+#include <hyprtoolkit-lua/Watchdog.hpp>
 #include <hyprtoolkit/palette/Color.hpp>
 #include <functional>
 
+#include "ColorCell.hpp"
+#include "ColorToken.hpp"
+#include "RefTracker.hpp"
+#include "SmartPtrAdapter.hpp"
+
 namespace Hyprtoolkit::Lua {
 
 using colorFn = std::function<CHyprColor()>;
 
-// Convert a Lua object (either a CHyprColor or a function) to colorFn
-inline colorFn luaToColorFn(sol::object obj) {
+// Convert a Lua object (a CHyprColor, a CColorCell, a CColorToken or a function) to colorFn.
+// owner/type/event attribute a function's pinned reference in CRefTracker.
+inline colorFn luaToColorFn(sol::object obj, const void* owner = nullptr, const char* type = "colorFn", const char* event = "color") {
     if (obj.is<CHyprColor>()) {
         // Static color - capture by value
         CHyprColor color = obj.as<CHyprColor>();
         return [color]() { return color; };
+    } else if (obj.is<Hyprutils::Memory::CSharedPointer<CColorCell>>()) {
+        // Live cell - read on every evaluation, no Lua involved
+        auto cell = obj.as<Hyprutils::Memory::CSharedPointer<CColorCell>>();
+        return [cell]() { return cell->get(); };
+    } else if (obj.is<CColorToken>()) {
+        // Palette token - resolved against the live palette, no Lua involved
+        CColorToken token = obj.as<CColorToken>();
+        return [token]() { return token.resolve(); };
     } else if (obj.is<sol::function>()) {
         // Dynamic color function
-        sol::protected_function fn = obj.as<sol::function>();
+        CLuaFunctionRef fn(obj.as<sol::function>(), owner, type, event);
         return [fn]() -> CHyprColor {
+            CTracer::CSpan                 span("colorFn", "colorFn", fn.type());
+            CWatchdog::CScope              watchdog(fn.function().lua_state(), "colorFn");
             sol::protected_function_result result = fn();
             if (result.valid()) {
                 return result.get<CHyprColor>();
             }
-            // Return black on error
-            fprintf(stderr, "[Lua] colorFn error: %s\n", sol::error(result).what());
+            // Return black on error; a colorFn failing every frame is reported once per window
+            CErrorLog::get().report("colorFn", sol::error(result).what());
             return CHyprColor(0.0, 0.0, 0.0, 1.0);
         };
     }
@@ -32,11 +51,11 @@ inline colorFn luaToColorFn(sol::object obj) {
 }
 
 // Convert a Lua object to an optional colorFn (returns nullopt if nil)
-inline std::optional<colorFn> luaToOptionalColorFn(sol::object obj) {
+inline std::optional<colorFn> luaToOptionalColorFn(sol::object obj, const void* owner = nullptr, const char* type = "colorFn", const char* event = "color") {
     if (obj.is<sol::nil_t>() || !obj.valid()) {
         return std::nullopt;
     }
-    return luaToColorFn(obj);
+    return luaToColorFn(obj, owner, type, event);
 }
 
 } // namespace Hyprtoolkit::Lua
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <hyprtoolkit/palette/Color.hpp>
+#include <hyprtoolkit/palette/Palette.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include "Async.hpp"
+
+namespace Hyprtoolkit::Lua {
+
+enum ePaletteColor : uint8_t {
+    PALETTE_BACKGROUND = 0,
+    PALETTE_TEXT,
+    PALETTE_BASE,
+    PALETTE_ALTERNATE_BASE,
+    PALETTE_BRIGHT_TEXT,
+    PALETTE_ACCENT,
+    PALETTE_ACCENT_SECONDARY,
+};
+
+// A palette entry plus adjustments, resolved against the live palette of the active
+// backend on every evaluation. Used as a color it needs no Lua at all and follows
+// palette changes.
+class CColorToken {
+  public:
+    CColorToken(ePaletteColor color, std::optional<float> alpha, float darken, float brighten) :
+        m_color(color), m_alpha(alpha), m_darken(darken), m_brighten(brighten) {}
+
+    static ePaletteColor colorFromName(const std::string& name) {
+        if (name == "background")
+            return PALETTE_BACKGROUND;
+        if (name == "text")
+            return PALETTE_TEXT;
+        if (name == "base")
+            return PALETTE_BASE;
+        if (name == "alternateBase")
+            return PALETTE_ALTERNATE_BASE;
+        if (name == "brightText")
+            return PALETTE_BRIGHT_TEXT;
+        if (name == "accent")
+            return PALETTE_ACCENT;
+        if (name == "accentSecondary")
+            return PALETTE_ACCENT_SECONDARY;
+        throw std::runtime_error("Color.token: unknown palette color '" + name + "'");
+    }
+
+    CHyprColor resolve() const {
+        // The backend whose loop runs is the one whose palette is on screen
+        auto backend = CMainQueue::get().backend();
+        auto palette = backend ? backend->getPalette() : nullptr;
+        if (!palette)
+            return CHyprColor(0.0, 0.0, 0.0, 1.0);
+
+        CHyprColor color = base(*palette);
+        if (m_darken > 0)
+            color = color.darken(m_darken);
+        if (m_brighten > 0)
+            color = color.brighten(m_brighten);
+        if (m_alpha)
+            color.a = *m_alpha;
+        return color;
+    }
+
+  private:
+    CHyprColor base(const CPalette& palette) const {
+        switch (m_color) {
+            case PALETTE_BACKGROUND: return palette.m_colors.background;
+            case PALETTE_TEXT: return palette.m_colors.text;
+            case PALETTE_BASE: return palette.m_colors.base;
+            case PALETTE_ALTERNATE_BASE: return palette.m_colors.alternateBase;
+            case PALETTE_BRIGHT_TEXT: return palette.m_colors.brightText;
+            case PALETTE_ACCENT: return palette.m_colors.accent;
+            case PALETTE_ACCENT_SECONDARY: return palette.m_colors.accentSecondary;
+        }
+        return palette.m_colors.text;
+    }
+
+    ePaletteColor        m_color = PALETTE_TEXT;
+    std::optional<float> m_alpha;
+    float                m_darken   = 0;
+    float                m_brighten = 0;
+};
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <sol/sol.hpp>
+#include <hyprtoolkit/element/Element.hpp>
+#include <hyprtoolkit/element/Text.hpp>
+#include <hyprtoolkit/element/Button.hpp>
+#include <hyprtoolkit/element/Textbox.hpp>
+#include <hyprtoolkit/element/Checkbox.hpp>
+#include <hyprtoolkit/element/Slider.hpp>
+#include <hyprtoolkit/element/Combobox.hpp>
+#include <hyprtoolkit/element/Spinbox.hpp>
+#include <hyprtoolkit/element/Rectangle.hpp>
+#include <hyprtoolkit/element/ColumnLayout.hpp>
+#include <hyprtoolkit/element/RowLayout.hpp>
+#include <hyprtoolkit/element/ScrollArea.hpp>
+#include <hyprtoolkit/element/Image.hpp>
+#include <hyprtoolkit/element/Null.hpp>
+#include <hyprtoolkit/element/Line.hpp>
+
+#include "SmartPtrAdapter.hpp"
+#include "ReflowLayout.hpp"
+#include "Canvas.hpp"
+#include "LogView.hpp"
+
+namespace Hyprtoolkit::Lua {
+
+// Get a CSharedPointer<IElement> out of any element userdata, or nullptr.
+// sol::bases doesn't convert smart pointers to a base, so every element type
+// has to be tried explicitly.
+inline Hyprutils::Memory::CSharedPointer<IElement> elementFromLua(const sol::object& obj) {
+    using Hyprutils::Memory::CSharedPointer;
+
+    if (obj.is<CSharedPointer<IElement>>())
+        return obj.as<CSharedPointer<IElement>>();
+
+#define TRY_ELEMENT_TYPE(T) \
+    if (obj.is<CSharedPointer<T>>()) \
+        return CSharedPointer<IElement>(obj.as<CSharedPointer<T>>());
+
+    // All element types need to be listed here for proper conversion
+    TRY_ELEMENT_TYPE(CTextElement)
+    TRY_ELEMENT_TYPE(CButtonElement)
+    TRY_ELEMENT_TYPE(CTextboxElement)
+    TRY_ELEMENT_TYPE(CCheckboxElement)
+    TRY_ELEMENT_TYPE(CSliderElement)
+    TRY_ELEMENT_TYPE(CComboboxElement)
+    TRY_ELEMENT_TYPE(CSpinboxElement)
+    TRY_ELEMENT_TYPE(CRectangleElement)
+    TRY_ELEMENT_TYPE(CColumnLayoutElement)
+    TRY_ELEMENT_TYPE(CRowLayoutElement)
+    TRY_ELEMENT_TYPE(CScrollAreaElement)
+    TRY_ELEMENT_TYPE(CImageElement)
+    TRY_ELEMENT_TYPE(CNullElement)
+    TRY_ELEMENT_TYPE(CLineElement)
+
+#undef TRY_ELEMENT_TYPE
+
+    // Grid and flow layouts, canvases and log views are added to parents through their container
+    if (obj.is<CSharedPointer<CGridLayoutElement>>())
+        return obj.as<CSharedPointer<CGridLayoutElement>>()->element();
+    if (obj.is<CSharedPointer<CFlowLayoutElement>>())
+        return obj.as<CSharedPointer<CFlowLayoutElement>>()->element();
+    if (obj.is<CSharedPointer<CCanvasElement>>())
+        return obj.as<CSharedPointer<CCanvasElement>>()->element();
+    if (obj.is<CSharedPointer<CLogViewElement>>())
+        return obj.as<CSharedPointer<CLogViewElement>>()->element();
+
+    return nullptr;
+}
+
+} // namespace Hyprtoolkit::Lua
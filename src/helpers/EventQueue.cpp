@@ -0,0 +1,202 @@
+#include "EventQueue.hpp"
+
+#include <hyprtoolkit-lua/Tracer.hpp>
+
+#include "Async.hpp"
+
+namespace Hyprtoolkit::Lua {
+
+// Address used as the registry key for the state's queue
+static const char EVENT_QUEUE_KEY = 0;
+
+static sol::object scalarToLua(sol::state_view lua, const LuaEventScalar& value) {
+    return std::visit(
+        [&lua](const auto& v) -> sol::object {
+            if constexpr (std::is_same_v<std::decay_t<decltype(v)>, std::monostate>)
+                return sol::make_object(lua, sol::lua_nil);
+            else
+                return sol::make_object(lua, v);
+        },
+        value);
+}
+
+static sol::object payloadToLua(sol::state_view lua, const LuaEventPayload& payload) {
+    return std::visit(
+        [&lua](const auto& v) -> sol::object {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, std::monostate>)
+                return sol::make_object(lua, sol::lua_nil);
+            else if constexpr (std::is_same_v<T, std::vector<std::pair<std::string, LuaEventScalar>>>) {
+                sol::table table = lua.create_table(0, v.size());
+                for (const auto& [key, value] : v) {
+                    table[key] = scalarToLua(lua, value);
+                }
+                return table;
+            } else
+                return sol::make_object(lua, v);
+        },
+        payload);
+}
+
+CEventQueue::CEventQueue(lua_State* L) : m_state(sol::main_thread(L, L)), m_head(&m_stub), m_tail(&m_stub) {
+    lua_pushlightuserdata(m_state, this);
+    lua_rawsetp(m_state, LUA_REGISTRYINDEX, &EVENT_QUEUE_KEY);
+}
+
+CEventQueue::~CEventQueue() {
+    if (fromState(m_state) == this) {
+        lua_pushnil(m_state);
+        lua_rawsetp(m_state, LUA_REGISTRYINDEX, &EVENT_QUEUE_KEY);
+    }
+
+    while (SNode* node = dequeue()) {
+        delete node;
+    }
+}
+
+CEventQueue* CEventQueue::fromState(lua_State* L) {
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &EVENT_QUEUE_KEY);
+    auto* queue = static_cast<CEventQueue*>(lua_touserdata(L, -1));
+    lua_pop(L, 1);
+    return queue;
+}
+
+// Vyukov's intrusive MPSC queue: one exchange per push, no locks, no CAS loops
+void CEventQueue::enqueue(SNode* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    SNode* prev = m_head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+// nullptr when empty, or while a producer is between its exchange and its link; that
+// producer wakes the queue again once linked
+CEventQueue::SNode* CEventQueue::dequeue() {
+    SNode* tail = m_tail;
+    SNode* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &m_stub) {
+        if (!next)
+            return nullptr;
+        m_tail = next;
+        tail   = next;
+        next   = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+
+    if (tail != m_head.load(std::memory_order_acquire))
+        return nullptr;
+
+    enqueue(&m_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (!next)
+        return nullptr;
+
+    m_tail = next;
+    return tail;
+}
+
+void CEventQueue::push(std::string event, LuaEventPayload payload) {
+    auto* node    = new SNode();
+    node->event   = std::move(event);
+    node->payload = std::move(payload);
+    enqueue(node);
+    m_posted.fetch_add(1, std::memory_order_relaxed);
+
+    // Only the first push since the last drain pays for a wake-up
+    if (!m_wakePending.exchange(true, std::memory_order_acq_rel))
+        wake();
+}
+
+void CEventQueue::wake() {
+    CMainQueue::get().post([weak = weak_from_this()]() {
+        if (auto queue = weak.lock())
+            queue->drain();
+    });
+}
+
+void CEventQueue::drain() {
+    // Cleared before reading, so a push racing with this drain wakes us again
+    m_wakePending.store(false, std::memory_order_seq_cst);
+    ++m_stats.wakeups;
+
+    CTracer::CSpan span("events", "events");
+
+    // Group by name keeping post order; names are delivered in order of first arrival
+    std::vector<std::pair<std::string, std::vector<LuaEventPayload>>> batches;
+    std::unordered_map<std::string, size_t>                           batchIndex;
+    size_t                                                            count = 0;
+
+    while (count < MAX_DRAIN) {
+        SNode* node = dequeue();
+        if (!node)
+            break;
+
+        auto [it, inserted] = batchIndex.try_emplace(node->event, batches.size());
+        if (inserted)
+            batches.emplace_back(std::move(node->event), std::vector<LuaEventPayload>{});
+        batches[it->second].second.push_back(std::move(node->payload));
+        delete node;
+        ++count;
+    }
+
+    if (count == MAX_DRAIN && !m_wakePending.exchange(true, std::memory_order_acq_rel))
+        wake();
+
+    sol::state_view lua(m_state);
+    for (auto& [event, payloads] : batches) {
+        auto subscribers = m_subscribers.find(event);
+        if (subscribers == m_subscribers.end() || subscribers->second.empty()) {
+            m_stats.dropped += payloads.size();
+            continue;
+        }
+
+        sol::table list = lua.create_table(payloads.size(), 0);
+        for (size_t i = 0; i < payloads.size(); ++i) {
+            list[i + 1] = payloadToLua(lua, payloads[i]);
+        }
+        m_stats.delivered += payloads.size();
+
+        // Handlers may (un)subscribe, so walk a snapshot of the ids
+        std::vector<uint64_t> ids;
+        for (const auto& [id, fn] : subscribers->second) {
+            ids.push_back(id);
+        }
+        for (const auto id : ids) {
+            auto& current = m_subscribers[event];
+            auto  fn      = current.find(id);
+            if (fn == current.end())
+                continue;
+            ++m_stats.batches;
+            invokeLuaCallback(fn->second, nullptr, list);
+        }
+    }
+}
+
+uint64_t CEventQueue::subscribe(const std::string& event, sol::protected_function fn) {
+    const auto id = m_nextId++;
+    m_subscribers[event].emplace(std::piecewise_construct, std::forward_as_tuple(id), std::forward_as_tuple(std::move(fn), this, "Events", "subscribe"));
+    m_subscriptionEvents.emplace(id, event);
+    return id;
+}
+
+bool CEventQueue::unsubscribe(uint64_t id) {
+    auto it = m_subscriptionEvents.find(id);
+    if (it == m_subscriptionEvents.end())
+        return false;
+
+    m_subscribers[it->second].erase(id);
+    m_subscriptionEvents.erase(it);
+    return true;
+}
+
+SEventQueueStats CEventQueue::stats() const {
+    auto stats   = m_stats;
+    stats.posted = m_posted.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <sol/sol.hpp>
+#include <hyprtoolkit-lua/LuaState.hpp>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CallbackAdapter.hpp"
+
+// Host threads -> Lua. CLuaState::post pushes onto a lock-free MPSC list from any
+// thread; the first push after a drain wakes the UI thread through CMainQueue's
+// eventfd, later ones only append. The drain hands each subscriber all events of its
+// name that arrived since, as one list, so a burst costs one wake-up and one Lua call.
+
+namespace Hyprtoolkit::Lua {
+
+struct SEventQueueStats {
+    uint64_t posted    = 0;
+    uint64_t delivered = 0;
+    uint64_t dropped   = 0; // no subscriber for the name at drain time
+    uint64_t wakeups   = 0;
+    uint64_t batches   = 0; // subscriber invocations
+};
+
+class CEventQueue : public std::enable_shared_from_this<CEventQueue> {
+  public:
+    explicit CEventQueue(lua_State* L);
+    ~CEventQueue();
+
+    CEventQueue(const CEventQueue&)            = delete;
+    CEventQueue& operator=(const CEventQueue&) = delete;
+
+    // The queue of L's state, or nullptr
+    static CEventQueue* fromState(lua_State* L);
+
+    // Any thread
+    void             push(std::string event, LuaEventPayload payload);
+
+    // UI thread only
+    uint64_t         subscribe(const std::string& event, sol::protected_function fn);
+    bool             unsubscribe(uint64_t id);
+    SEventQueueStats stats() const;
+
+  private:
+    struct SNode {
+        std::atomic<SNode*> next = nullptr;
+        std::string         event;
+        LuaEventPayload     payload;
+    };
+
+    // Events handled per wake-up; the rest waits for an immediate second one
+    static constexpr size_t MAX_DRAIN = 65536;
+
+    void                                                                 enqueue(SNode* node);
+    SNode*                                                               dequeue();
+    void                                                                 wake();
+    void                                                                 drain();
+
+    lua_State*                                                           m_state = nullptr;
+
+    // Producers swap m_head, the UI thread walks from m_tail
+    std::atomic<SNode*>                                                  m_head;
+    SNode*                                                               m_tail = nullptr;
+    SNode                                                                m_stub;
+    std::atomic<bool>                                                    m_wakePending = false;
+    std::atomic<uint64_t>                                                m_posted      = 0;
+
+    // By event name, then subscription id so delivery follows subscription order
+    std::unordered_map<std::string, std::map<uint64_t, CLuaFunctionRef>> m_subscribers;
+    std::unordered_map<uint64_t, std::string>                            m_subscriptionEvents;
+    uint64_t                                                             m_nextId = 1;
+    SEventQueueStats                                                     m_stats;
+};
+
+} // namespace Hyprtoolkit::Lua
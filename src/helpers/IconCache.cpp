@@ -0,0 +1,135 @@
+#include "IconCache.hpp"
+
+#include <hyprtoolkit/palette/Palette.hpp>
+#include <hyprtoolkit-lua/Tracer.hpp>
+#include <chrono>
+
+#include "Async.hpp"
+
+using namespace Hyprutils::Memory;
+
+namespace Hyprtoolkit::Lua {
+
+// The palette on screen decides the theme lookups resolve against
+static std::string currentIconTheme() {
+    auto backend = CMainQueue::get().backend();
+    auto palette = backend ? backend->getPalette() : nullptr;
+    return palette ? palette->m_vars.iconTheme : std::string();
+}
+
+// Leaked like the async singletons: worker batches may still reference it at exit
+CIconCache& CIconCache::get() {
+    static auto* cache = new CIconCache();
+    return *cache;
+}
+
+void CIconCache::clear() {
+    if (!m_entries.empty())
+        ++m_stats.cleared;
+    m_entries.clear();
+    m_stats.notFound = 0;
+    ++m_generation;
+}
+
+void CIconCache::sync(ISystemIconFactory* factory, const std::string& theme) {
+    if (factory == m_factory && theme == m_theme)
+        return;
+
+    clear();
+    m_factory = factory;
+    m_theme   = theme;
+}
+
+void CIconCache::store(const std::string& name, CSharedPointer<ISystemIconDescription> icon) {
+    if (!icon || !icon->exists())
+        ++m_stats.notFound;
+    m_entries.emplace(name, std::move(icon));
+}
+
+CSharedPointer<ISystemIconDescription> CIconCache::lookup(const CSharedPointer<ISystemIconFactory>& factory, const std::string& name) {
+    if (!factory)
+        return nullptr;
+
+    const auto      theme = currentIconTheme();
+    std::lock_guard lock(m_mutex);
+    sync(factory.get(), theme);
+
+    if (auto it = m_entries.find(name); it != m_entries.end()) {
+        ++m_stats.hits;
+        return it->second;
+    }
+
+    ++m_stats.misses;
+    // The span outlives name in the trace buffer, so the detail must be interned
+    auto&          tracer = CTracer::get();
+    CTracer::CSpan span("lookupIcon", "icons", tracer.enabled() ? tracer.intern(name) : nullptr);
+    auto           icon = factory->lookupIcon(name);
+    store(name, icon);
+    return icon;
+}
+
+// Time one prewarm slice may take before the loop gets to handle events again
+static constexpr auto PREWARM_SLICE = std::chrono::milliseconds(2);
+
+void CIconCache::prewarm(const CSharedPointer<ISystemIconFactory>& factory, std::vector<std::string> names, std::function<void(size_t)> done) {
+    auto batch = std::make_shared<SPrewarmBatch>();
+    {
+        std::lock_guard lock(m_mutex);
+        if (factory)
+            sync(factory.get(), currentIconTheme());
+        std::erase_if(names, [this](const auto& name) { return m_entries.contains(name); });
+        batch->generation = m_generation;
+    }
+
+    batch->factory = factory;
+    batch->done    = std::move(done);
+    if (factory)
+        batch->names = std::move(names);
+
+    // Completions are always asynchronous, even with nothing left to resolve
+    CMainQueue::get().post([this, batch]() { prewarmSlice(batch); });
+}
+
+void CIconCache::prewarmSlice(const std::shared_ptr<SPrewarmBatch>& batch) {
+    {
+        CTracer::CSpan  span("prewarm", "icons");
+        std::lock_guard lock(m_mutex);
+        const auto      deadline = std::chrono::steady_clock::now() + PREWARM_SLICE;
+        while (batch->next < batch->names.size() && std::chrono::steady_clock::now() < deadline) {
+            if (m_generation != batch->generation || m_factory != batch->factory.get()) {
+                batch->next = batch->names.size(); // theme changed or cache cleared, the results would be stale
+                break;
+            }
+
+            const auto& name = batch->names[batch->next++];
+            if (m_entries.contains(name))
+                continue;
+
+            store(name, batch->factory->lookupIcon(name));
+            ++m_stats.prewarmed;
+            ++batch->resolved;
+        }
+    }
+
+    if (batch->next < batch->names.size()) {
+        CMainQueue::get().post([this, batch]() { prewarmSlice(batch); });
+        return;
+    }
+
+    if (batch->done)
+        batch->done(batch->resolved);
+}
+
+void CIconCache::invalidate() {
+    std::lock_guard lock(m_mutex);
+    clear();
+}
+
+SIconCacheStats CIconCache::stats() {
+    std::lock_guard lock(m_mutex);
+    auto            stats = m_stats;
+    stats.entries         = m_entries.size();
+    return stats;
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <hyprtoolkit/system/Icons.hpp>
+#include <hyprutils/memory/SharedPtr.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Memoized system icon lookups. Results, misses included, are kept per name for the
+// palette's current icon theme; a theme change drops them all. prewarm() resolves a
+// batch ahead of use so later lookups only hit the cache. It runs in short slices
+// between the loop's events rather than on a worker: hyprtoolkit resolves icons with
+// the same factory on the UI thread and doesn't promise it is thread safe, so every
+// factory call stays on the UI thread.
+
+namespace Hyprtoolkit::Lua {
+
+struct SIconCacheStats {
+    uint64_t hits      = 0;
+    uint64_t misses    = 0; // lookups that reached the factory from the UI thread
+    uint64_t prewarmed = 0; // lookups done by prewarm batches
+    uint64_t notFound  = 0; // cached results without an icon
+    uint64_t cleared   = 0; // invalidations, explicit or by a theme change
+    size_t   entries   = 0;
+};
+
+class CIconCache {
+  public:
+    static CIconCache& get();
+
+    // UI thread. Same result as factory->lookupIcon(name), from the cache when possible.
+    Hyprutils::Memory::CSharedPointer<ISystemIconDescription> lookup(const Hyprutils::Memory::CSharedPointer<ISystemIconFactory>& factory, const std::string& name);
+
+    // UI thread. Resolves the uncached names a slice at a time, then runs
+    // done(resolved). The batch keeps the factory alive until it finishes.
+    void            prewarm(const Hyprutils::Memory::CSharedPointer<ISystemIconFactory>& factory, std::vector<std::string> names, std::function<void(size_t)> done);
+
+    void            invalidate();
+    SIconCacheStats stats();
+
+  private:
+    using IconMap = std::unordered_map<std::string, Hyprutils::Memory::CSharedPointer<ISystemIconDescription>>;
+
+    struct SPrewarmBatch {
+        Hyprutils::Memory::CSharedPointer<ISystemIconFactory> factory;
+        std::vector<std::string>                              names;
+        size_t                                                next       = 0;
+        size_t                                                resolved   = 0;
+        uint64_t                                              generation = 0;
+        std::function<void(size_t)>                           done;
+    };
+
+    CIconCache() = default;
+
+    // With m_mutex held. sync() drops everything if the theme or factory changed.
+    void                store(const std::string& name, Hyprutils::Memory::CSharedPointer<ISystemIconDescription> icon);
+    void                sync(ISystemIconFactory* factory, const std::string& theme);
+    void                clear();
+    void                prewarmSlice(const std::shared_ptr<SPrewarmBatch>& batch);
+
+    std::mutex          m_mutex;
+    ISystemIconFactory* m_factory = nullptr;
+    std::string         m_theme;
+    uint64_t            m_generation = 0; // bumped on every clear, stale batches stop
+    IconMap             m_entries;
+    SIconCacheStats     m_stats;
+};
+
+} // namespace Hyprtoolkit::Lua
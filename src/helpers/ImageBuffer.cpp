@@ -0,0 +1,284 @@
+#include "ImageBuffer.hpp"
+
+#include <hyprgraphics/image/Image.hpp>
+#include <cairo/cairo.h>
+#include <pixman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+#include "RuntimeImage.hpp"
+
+namespace Hyprtoolkit::Lua {
+
+static std::atomic<uint64_t> nextBufferId = 1;
+
+static SPixels blank(int width, int height) {
+    SPixels out;
+    out.width  = std::max(1, width);
+    out.height = std::max(1, height);
+    out.data.assign(static_cast<size_t>(out.width) * out.height, 0);
+    return out;
+}
+
+// pixman only reads from sources, the const_cast never leads to a write
+static pixman_image_t* sourceImage(const SPixels& src) {
+    return pixman_image_create_bits(PIXMAN_a8r8g8b8, src.width, src.height, const_cast<uint32_t*>(src.data.data()), src.width * 4);
+}
+
+static pixman_image_t* targetImage(SPixels& dst) {
+    return pixman_image_create_bits(PIXMAN_a8r8g8b8, dst.width, dst.height, dst.data.data(), dst.width * 4);
+}
+
+// Composites src into a new width x height image through a dest -> src transform
+static SPixels transformed(const SPixels& src, int width, int height, const pixman_f_transform& transform, pixman_filter_t filter, pixman_repeat_t repeat) {
+    SPixels         out    = blank(width, height);
+    pixman_image_t* source = sourceImage(src);
+    pixman_image_t* target = targetImage(out);
+
+    pixman_transform_t fixed;
+    pixman_transform_from_pixman_f_transform(&fixed, &transform);
+    pixman_image_set_transform(source, &fixed);
+    pixman_image_set_filter(source, filter, nullptr, 0);
+    pixman_image_set_repeat(source, repeat);
+    pixman_image_composite32(PIXMAN_OP_SRC, source, nullptr, target, 0, 0, 0, 0, 0, 0, out.width, out.height);
+
+    pixman_image_unref(source);
+    pixman_image_unref(target);
+    return out;
+}
+
+static SPixels resample(const SPixels& src, int width, int height) {
+    pixman_f_transform transform;
+    pixman_f_transform_init_scale(&transform, static_cast<double>(src.width) / width, static_cast<double>(src.height) / height);
+    return transformed(src, width, height, transform, PIXMAN_FILTER_BILINEAR, PIXMAN_REPEAT_PAD);
+}
+
+std::optional<SPixels> loadPixels(const std::string& path, std::string& error) {
+    Hyprgraphics::CImage image(path);
+    if (!image.success()) {
+        error = image.getError();
+        return std::nullopt;
+    }
+
+    cairo_surface_t* surface = image.cairoSurface()->cairo();
+    cairo_surface_flush(surface);
+
+    const auto format = cairo_image_surface_get_format(surface);
+    if (format != CAIRO_FORMAT_ARGB32 && format != CAIRO_FORMAT_RGB24) {
+        error = "unsupported pixel format";
+        return std::nullopt;
+    }
+
+    SPixels     out    = blank(cairo_image_surface_get_width(surface), cairo_image_surface_get_height(surface));
+    const int   stride = cairo_image_surface_get_stride(surface);
+    const auto* data   = cairo_image_surface_get_data(surface);
+    const bool  opaque = format == CAIRO_FORMAT_RGB24;
+    for (int y = 0; y < out.height; ++y) {
+        const auto* row = reinterpret_cast<const uint32_t*>(data + static_cast<size_t>(y) * stride);
+        auto*       dst = out.data.data() + static_cast<size_t>(y) * out.width;
+        for (int x = 0; x < out.width; ++x) {
+            dst[x] = opaque ? row[x] | 0xFF000000U : row[x];
+        }
+    }
+
+    return out;
+}
+
+SPixels scalePixels(const SPixels& src, int width, int height) {
+    width  = std::max(1, width);
+    height = std::max(1, height);
+
+    // Mipmap-style prefilter: bilinear sampling at exactly half size averages 2x2
+    // blocks, so each halving is a box filter and the final step stays within 2x
+    SPixels        halved;
+    const SPixels* current = &src;
+    while (current->width >= width * 2 && current->height >= height * 2) {
+        halved  = resample(*current, current->width / 2, current->height / 2);
+        current = &halved;
+    }
+
+    if (current->width == width && current->height == height)
+        return *current;
+    return resample(*current, width, height);
+}
+
+SPixels thumbnailPixels(const SPixels& src, int maxWidth, int maxHeight) {
+    const double factor = std::min({1.0, static_cast<double>(maxWidth) / src.width, static_cast<double>(maxHeight) / src.height});
+    if (factor >= 1.0)
+        return src;
+    return scalePixels(src, static_cast<int>(std::round(src.width * factor)), static_cast<int>(std::round(src.height * factor)));
+}
+
+SPixels cropPixels(const SPixels& src, int x, int y, int width, int height) {
+    x      = std::clamp(x, 0, src.width - 1);
+    y      = std::clamp(y, 0, src.height - 1);
+    width  = std::clamp(width, 1, src.width - x);
+    height = std::clamp(height, 1, src.height - y);
+
+    SPixels out = blank(width, height);
+    for (int row = 0; row < height; ++row) {
+        const auto* from = src.data.data() + static_cast<size_t>(y + row) * src.width + x;
+        std::copy(from, from + width, out.data.data() + static_cast<size_t>(row) * width);
+    }
+    return out;
+}
+
+SPixels rotatePixels(const SPixels& src, double degrees) {
+    degrees = std::fmod(std::fmod(degrees, 360.0) + 360.0, 360.0);
+
+    // Quarter turns are exact pixel moves
+    if (degrees == 0)
+        return src;
+    if (degrees == 90 || degrees == 180 || degrees == 270) {
+        const bool swap = degrees != 180;
+        SPixels    out  = blank(swap ? src.height : src.width, swap ? src.width : src.height);
+        for (int y = 0; y < src.height; ++y) {
+            for (int x = 0; x < src.width; ++x) {
+                int dx = x, dy = y;
+                if (degrees == 90) {
+                    dx = src.height - 1 - y;
+                    dy = x;
+                } else if (degrees == 180) {
+                    dx = src.width - 1 - x;
+                    dy = src.height - 1 - y;
+                } else {
+                    dx = y;
+                    dy = src.width - 1 - x;
+                }
+                out.data[static_cast<size_t>(dy) * out.width + dx] = src.data[static_cast<size_t>(y) * src.width + x];
+            }
+        }
+        return out;
+    }
+
+    // Anything else is resampled into the rotated bounding box
+    const double rad    = degrees * std::numbers::pi / 180.0;
+    const double c      = std::cos(rad);
+    const double s      = std::sin(rad);
+    const int    width  = static_cast<int>(std::ceil(std::abs(src.width * c) + std::abs(src.height * s)));
+    const int    height = static_cast<int>(std::ceil(std::abs(src.width * s) + std::abs(src.height * c)));
+
+    pixman_f_transform transform;
+    pixman_f_transform_init_identity(&transform);
+    pixman_f_transform_translate(&transform, nullptr, -width / 2.0, -height / 2.0);
+    pixman_f_transform_rotate(&transform, nullptr, c, -s);
+    pixman_f_transform_translate(&transform, nullptr, src.width / 2.0, src.height / 2.0);
+    return transformed(src, width, height, transform, PIXMAN_FILTER_BILINEAR, PIXMAN_REPEAT_NONE);
+}
+
+// One pass of a separable gaussian through pixman's convolution filter
+static SPixels convolve(const SPixels& src, const std::vector<pixman_fixed_t>& kernel, bool horizontal) {
+    std::vector<pixman_fixed_t> params;
+    params.reserve(kernel.size() + 2);
+    params.push_back(pixman_int_to_fixed(horizontal ? kernel.size() : 1));
+    params.push_back(pixman_int_to_fixed(horizontal ? 1 : kernel.size()));
+    params.insert(params.end(), kernel.begin(), kernel.end());
+
+    SPixels         out    = blank(src.width, src.height);
+    pixman_image_t* source = sourceImage(src);
+    pixman_image_t* target = targetImage(out);
+    pixman_image_set_filter(source, PIXMAN_FILTER_CONVOLUTION, params.data(), params.size());
+    pixman_image_set_repeat(source, PIXMAN_REPEAT_PAD);
+    pixman_image_composite32(PIXMAN_OP_SRC, source, nullptr, target, 0, 0, 0, 0, 0, 0, out.width, out.height);
+    pixman_image_unref(source);
+    pixman_image_unref(target);
+    return out;
+}
+
+SPixels blurPixels(const SPixels& src, double radius) {
+    const int taps = static_cast<int>(std::ceil(std::clamp(radius, 0.0, 64.0)));
+    if (taps <= 0)
+        return src;
+
+    const double        sigma = std::max(0.5, radius / 2.0);
+    std::vector<double> weights(taps * 2 + 1);
+    double              sum = 0;
+    for (int i = -taps; i <= taps; ++i) {
+        weights[i + taps] = std::exp(-(i * i) / (2 * sigma * sigma));
+        sum += weights[i + taps];
+    }
+
+    std::vector<pixman_fixed_t> kernel;
+    kernel.reserve(weights.size());
+    for (const double w : weights) {
+        kernel.push_back(pixman_double_to_fixed(w / sum));
+    }
+
+    return convolve(convolve(src, kernel, true), kernel, false);
+}
+
+SPixels colorMatrixPixels(const SPixels& src, const std::array<double, 20>& m) {
+    SPixels out = blank(src.width, src.height);
+    for (size_t i = 0; i < src.data.size(); ++i) {
+        const uint32_t px = src.data[i];
+        const double   a  = (px >> 24) / 255.0;
+        if (a <= 0 && m[19] <= 0)
+            continue;
+
+        // Matrices work on straight alpha
+        const double r = a > 0 ? ((px >> 16) & 0xFF) / 255.0 / a : 0;
+        const double g = a > 0 ? ((px >> 8) & 0xFF) / 255.0 / a : 0;
+        const double b = a > 0 ? (px & 0xFF) / 255.0 / a : 0;
+
+        std::array<double, 4> res;
+        for (size_t row = 0; row < 4; ++row) {
+            const double* k = &m[row * 5];
+            res[row]        = std::clamp(k[0] * r + k[1] * g + k[2] * b + k[3] * a + k[4], 0.0, 1.0);
+        }
+
+        auto channel = [alpha = res[3]](double v) { return static_cast<uint32_t>(v * alpha * 255.0 + 0.5); };
+        out.data[i]  = static_cast<uint32_t>(res[3] * 255.0 + 0.5) << 24 | channel(res[0]) << 16 | channel(res[1]) << 8 | channel(res[2]);
+    }
+    return out;
+}
+
+SPixels applyImageOps(const SPixels& src, const std::vector<SImageOp>& ops) {
+    SPixels current = src;
+    for (const auto& op : ops) {
+        const auto& a = op.args;
+        switch (op.op) {
+            case IMAGE_OP_SCALE: current = scalePixels(current, a[0], a[1]); break;
+            case IMAGE_OP_THUMBNAIL: current = thumbnailPixels(current, a[0], a[1]); break;
+            case IMAGE_OP_CROP: current = cropPixels(current, a[0], a[1], a[2], a[3]); break;
+            case IMAGE_OP_ROTATE: current = rotatePixels(current, a[0]); break;
+            case IMAGE_OP_BLUR: current = blurPixels(current, a[0]); break;
+            case IMAGE_OP_COLOR_MATRIX: current = colorMatrixPixels(current, a); break;
+        }
+    }
+    return current;
+}
+
+CImageBuffer::CImageBuffer(std::shared_ptr<const SPixels> pixels, std::string file) : m_pixels(std::move(pixels)), m_file(std::move(file)), m_id(nextBufferId++) {}
+
+CImageBuffer::~CImageBuffer() {
+    if (!m_file.empty())
+        unlink(m_file.c_str());
+}
+
+int CImageBuffer::width() const {
+    return m_pixels->width;
+}
+
+int CImageBuffer::height() const {
+    return m_pixels->height;
+}
+
+const std::shared_ptr<const SPixels>& CImageBuffer::pixels() const {
+    return m_pixels;
+}
+
+const std::string& CImageBuffer::file() {
+    if (m_file.empty()) {
+        const auto path = runtimeImagePath("image", m_id, 0);
+        if (!writeRuntimeImage(path, m_pixels->data.data(), m_pixels->width, m_pixels->height))
+            throw std::runtime_error("CImageBuffer: failed to write " + path);
+        m_file = path;
+    }
+    return m_file;
+}
+
+} // namespace Hyprtoolkit::Lua
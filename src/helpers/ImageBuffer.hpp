@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Decoded images and pixman operations on them. The functions below only read their
+// input and return a new image, so they can run on CWorkerPool threads; CImageBuffer
+// shares its pixels through std::shared_ptr for the same reason.
+
+namespace Hyprtoolkit::Lua {
+
+// Premultiplied ARGB32, rows tightly packed
+struct SPixels {
+    int                   width  = 0;
+    int                   height = 0;
+    std::vector<uint32_t> data;
+};
+
+enum eImageOp : uint8_t {
+    IMAGE_OP_SCALE = 0,   // w, h
+    IMAGE_OP_THUMBNAIL,   // max w, max h
+    IMAGE_OP_CROP,        // x, y, w, h
+    IMAGE_OP_ROTATE,      // degrees clockwise
+    IMAGE_OP_BLUR,        // radius
+    IMAGE_OP_COLOR_MATRIX // 4x5 row-major, offsets in 0..1
+};
+
+struct SImageOp {
+    eImageOp               op = IMAGE_OP_SCALE;
+    std::array<double, 20> args{};
+};
+
+std::optional<SPixels> loadPixels(const std::string& path, std::string& error);
+
+// Downscales in 2x box-filtered steps first, so large reductions don't alias
+SPixels                scalePixels(const SPixels& src, int width, int height);
+// Fits into max width x max height keeping the aspect ratio, never upscales
+SPixels                thumbnailPixels(const SPixels& src, int maxWidth, int maxHeight);
+SPixels                cropPixels(const SPixels& src, int x, int y, int width, int height);
+SPixels                rotatePixels(const SPixels& src, double degrees);
+SPixels                blurPixels(const SPixels& src, double radius);
+SPixels                colorMatrixPixels(const SPixels& src, const std::array<double, 20>& matrix);
+
+SPixels                applyImageOps(const SPixels& src, const std::vector<SImageOp>& ops);
+
+class CImageBuffer {
+  public:
+    explicit CImageBuffer(std::shared_ptr<const SPixels> pixels, std::string file = "");
+    ~CImageBuffer();
+
+    CImageBuffer(const CImageBuffer&)            = delete;
+    CImageBuffer& operator=(const CImageBuffer&) = delete;
+
+    int                                   width() const;
+    int                                   height() const;
+    const std::shared_ptr<const SPixels>& pixels() const;
+
+    // PNG of the buffer for CImageBuilder, written on first use and removed with the buffer
+    const std::string&                    file();
+
+  private:
+    std::shared_ptr<const SPixels> m_pixels;
+    std::string                    m_file;
+    uint64_t                       m_id = 0;
+};
+
+} // namespace Hyprtoolkit::Lua
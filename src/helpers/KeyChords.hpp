@@ -0,0 +1,230 @@
+#pragma once
+
+#include <sol/sol.hpp>
+#include <hyprtoolkit/core/Input.hpp>
+#include <xkbcommon/xkbcommon.h>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "CallbackAdapter.hpp"
+#include "RefTracker.hpp"
+
+// Native keybinding table for windows. Bindings like "ctrl+shift+p" or multi-stroke
+// chords like "ctrl+k ctrl+s" are parsed once into a trie of key strokes; key events
+// walk the trie in C++ and Lua is only entered when a full chord matches.
+
+namespace Hyprtoolkit::Lua {
+
+// One key press: normalized keysym plus the modifiers that must be held
+struct SKeyStroke {
+    xkb_keysym_t sym  = XKB_KEY_NoSymbol;
+    uint32_t     mods = 0;
+
+    uint64_t     key() const {
+        return (static_cast<uint64_t>(mods) << 32) | sym;
+    }
+};
+
+// Modifiers that take part in matching. Caps and num lock (mod2) never do.
+inline constexpr uint32_t CHORD_MODIFIER_MASK = Input::HT_MODIFIER_SHIFT | Input::HT_MODIFIER_CTRL | Input::HT_MODIFIER_ALT | Input::HT_MODIFIER_META |
+    Input::HT_MODIFIER_MOD3 | Input::HT_MODIFIER_MOD5;
+
+inline bool isModifierKeysym(xkb_keysym_t sym) {
+    return (sym >= XKB_KEY_Shift_L && sym <= XKB_KEY_Hyper_R) || sym == XKB_KEY_ISO_Level3_Shift || sym == XKB_KEY_ISO_Level5_Shift;
+}
+
+// Shifted letters arrive as uppercase keysyms, bindings are matched on the lowercase one
+inline xkb_keysym_t normalizeKeysym(xkb_keysym_t sym) {
+    return xkb_keysym_to_lower(sym);
+}
+
+inline std::optional<uint32_t> modifierFromName(std::string_view name) {
+    if (name == "ctrl" || name == "control")
+        return Input::HT_MODIFIER_CTRL;
+    if (name == "shift")
+        return Input::HT_MODIFIER_SHIFT;
+    if (name == "alt")
+        return Input::HT_MODIFIER_ALT;
+    if (name == "super" || name == "meta" || name == "logo")
+        return Input::HT_MODIFIER_META;
+    if (name == "mod3")
+        return Input::HT_MODIFIER_MOD3;
+    if (name == "mod5")
+        return Input::HT_MODIFIER_MOD5;
+    return std::nullopt;
+}
+
+// "ctrl+shift+p" -> one stroke. The last component is the key, looked up by its
+// xkb name ("p", "Escape", "F5", "plus") or a literal '+' ("ctrl++"); throws on
+// unknown names.
+inline SKeyStroke parseKeyStroke(std::string_view text) {
+    SKeyStroke stroke;
+
+    while (true) {
+        const auto  plus = text.find('+', 1); // a leading '+' is the key itself
+        const auto  part = text.substr(0, plus);
+        std::string lower(part);
+        for (auto& c : lower) {
+            c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        }
+
+        if (plus == std::string_view::npos) {
+            // xkb knows '+' only as "plus"
+            if (part == "+")
+                stroke.sym = XKB_KEY_plus;
+            else
+                stroke.sym = xkb_keysym_from_name(std::string(part).c_str(), XKB_KEYSYM_NO_FLAGS);
+            if (stroke.sym == XKB_KEY_NoSymbol)
+                stroke.sym = xkb_keysym_from_name(lower.c_str(), XKB_KEYSYM_CASE_INSENSITIVE);
+            if (stroke.sym == XKB_KEY_NoSymbol)
+                throw std::runtime_error("bindKeys: unknown key '" + std::string(part) + "'");
+            stroke.sym = normalizeKeysym(stroke.sym);
+            return stroke;
+        }
+
+        auto mod = modifierFromName(lower);
+        if (!mod)
+            throw std::runtime_error("bindKeys: unknown modifier '" + std::string(part) + "'");
+        stroke.mods |= *mod;
+        text.remove_prefix(plus + 1);
+    }
+}
+
+// "ctrl+k ctrl+s" -> two strokes
+inline std::vector<SKeyStroke> parseKeyChord(std::string_view text) {
+    std::vector<SKeyStroke> strokes;
+
+    while (!text.empty()) {
+        const auto start = text.find_first_not_of(' ');
+        if (start == std::string_view::npos)
+            break;
+        text.remove_prefix(start);
+
+        const auto end = text.find(' ');
+        strokes.push_back(parseKeyStroke(text.substr(0, end)));
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end);
+    }
+
+    if (strokes.empty())
+        throw std::runtime_error("bindKeys: empty key chord");
+
+    return strokes;
+}
+
+class CKeyChordTrie {
+  public:
+    // Strokes of a multi-stroke chord must follow each other within this time
+    static constexpr std::chrono::milliseconds CHORD_TIMEOUT{1500};
+
+    explicit CKeyChordTrie(const void* owner) : m_owner(owner) {
+        m_nodes.emplace_back();
+    }
+
+    void bind(const std::string& chord, sol::protected_function fn) {
+        auto   strokes = parseKeyChord(chord);
+        size_t node    = 0;
+
+        for (const auto& stroke : strokes) {
+            auto it = m_nodes[node].children.find(stroke.key());
+            if (it == m_nodes[node].children.end()) {
+                m_nodes.emplace_back();
+                it = m_nodes[node].children.emplace(stroke.key(), m_nodes.size() - 1).first;
+            }
+            node = it->second;
+        }
+
+        m_nodes[node].chord = chord;
+        m_nodes[node].handler.emplace(std::move(fn), m_owner, "IWindow", "bindKeys");
+        m_pending = 0;
+    }
+
+    void unbind(const std::string& chord) {
+        auto   strokes = parseKeyChord(chord);
+        size_t node    = 0;
+
+        for (const auto& stroke : strokes) {
+            auto it = m_nodes[node].children.find(stroke.key());
+            if (it == m_nodes[node].children.end())
+                return;
+            node = it->second;
+        }
+
+        // Nodes are kept; an unbound node only acts as a chord prefix from now on
+        m_nodes[node].handler.reset();
+        m_pending = 0;
+    }
+
+    // Returns true if the event was part of a bound chord
+    bool dispatch(const Input::SKeyboardKeyEvent& event) {
+        if (!event.down || isModifierKeysym(event.xkbKeysym))
+            return false;
+
+        const auto now = std::chrono::steady_clock::now();
+        if (m_pending != 0 && now - m_lastStroke > CHORD_TIMEOUT)
+            m_pending = 0;
+
+        // Key repeat only re-triggers single-stroke bindings, never advances a chord
+        if (event.repeat && m_pending != 0)
+            return false;
+
+        const SKeyStroke stroke{.sym = normalizeKeysym(event.xkbKeysym), .mods = event.modMask & CHORD_MODIFIER_MASK};
+
+        auto             it = m_nodes[m_pending].children.find(stroke.key());
+        if (it == m_nodes[m_pending].children.end() && m_pending != 0) {
+            // Broken chord: the stroke may still start a new one
+            m_pending = 0;
+            it        = m_nodes[0].children.find(stroke.key());
+        }
+
+        if (it == m_nodes[m_pending].children.end())
+            return false;
+
+        const auto& node = m_nodes[it->second];
+        m_lastStroke     = now;
+
+        if (!node.children.empty()) {
+            // Prefix of a longer chord; a binding on the prefix itself is shadowed
+            m_pending = it->second;
+            return true;
+        }
+
+        m_pending = 0;
+        if (!node.handler)
+            return false;
+
+        // The handler may rebind keys and reallocate m_nodes, so call through copies
+        const auto handler = *node.handler;
+        const auto chord   = node.chord;
+        invokeLuaCallback(handler, nullptr, chord);
+        return true;
+    }
+
+    size_t size() const {
+        size_t n = 0;
+        for (const auto& node : m_nodes) {
+            n += node.handler.has_value();
+        }
+        return n;
+    }
+
+  private:
+    struct SNode {
+        std::unordered_map<uint64_t, size_t> children;
+        std::optional<CLuaFunctionRef>       handler;
+        std::string                          chord;
+    };
+
+    const void*                           m_owner = nullptr;
+    std::vector<SNode>                    m_nodes;
+    size_t                                m_pending = 0;
+    std::chrono::steady_clock::time_point m_lastStroke;
+};
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,274 @@
+#include "LogView.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+#include <hyprtoolkit-lua/Tracer.hpp>
+
+#include "Async.hpp"
+
+using namespace Hyprutils::Memory;
+using namespace Hyprutils::Math;
+
+namespace Hyprtoolkit::Lua {
+
+static CDynamicSize fillParent() {
+    return CDynamicSize(CDynamicSize::HT_SIZE_PERCENT, CDynamicSize::HT_SIZE_PERCENT, {1, 1});
+}
+
+// Refresh once the current frame's appends are in
+static void scheduleRefresh(const CSharedPointer<SLogViewState>& state) {
+    if (state->scheduled)
+        return;
+
+    auto backend = CMainQueue::get().backend();
+    if (!backend) {
+        state->refresh();
+        return;
+    }
+
+    state->scheduled = true;
+    backend->addIdle([weak = CWeakPointer<SLogViewState>(state)]() {
+        auto state = weak.lock();
+        if (!state)
+            return;
+
+        state->scheduled = false;
+        state->refresh();
+    });
+}
+
+size_t SLogViewState::count() const {
+    return nextSeq - firstSeq;
+}
+
+const std::string& SLogViewState::at(uint64_t seq) const {
+    return lines[(head + (seq - firstSeq)) % lines.size()];
+}
+
+void SLogViewState::push(std::string_view line) {
+    if (lines.size() < settings.capacity) {
+        lines.emplace_back(line);
+        ++nextSeq;
+        return;
+    }
+
+    // Full: overwrite the oldest slot, reusing its allocation
+    lines[head].assign(line);
+    head = (head + 1) % lines.size();
+    ++firstSeq;
+    ++nextSeq;
+}
+
+size_t SLogViewState::visibleRows() const {
+    auto box = container.lock();
+    if (!box || settings.lineHeight <= 0)
+        return 0;
+    return static_cast<size_t>(std::max(0.0, std::floor(box->size().y / settings.lineHeight)));
+}
+
+uint64_t SLogViewState::topLine() const {
+    const auto rowsShown = visibleRows();
+    const auto bottomTop = count() > rowsShown ? nextSeq - rowsShown : firstSeq;
+    if (follow)
+        return bottomTop;
+    return std::clamp(top, firstSeq, bottomTop);
+}
+
+void SLogViewState::refresh() {
+    auto box = container.lock();
+    if (!box || refreshing)
+        return;
+
+    CTracer::CSpan span("refresh", "logview");
+    refreshing = true;
+
+    const auto first = topLine();
+    const auto last  = std::min<uint64_t>(nextSeq, first + visibleRows());
+    const auto width = box->size().x;
+
+    // Rows still on screen keep their element; the rest are recycled for new lines
+    std::vector<CSharedPointer<CTextElement>> spare;
+    for (auto it = rows.begin(); it != rows.end();) {
+        if (it->first < first || it->first >= last) {
+            spare.push_back(it->second);
+            it = rows.erase(it);
+        } else
+            ++it;
+    }
+
+    for (auto seq = first; seq < last; ++seq) {
+        auto& row = rows[seq];
+        if (!row) {
+            const bool recycled = !spare.empty();
+            auto       builder  = recycled ? spare.back()->rebuild() : CTextBuilder::begin();
+            if (recycled)
+                spare.pop_back();
+
+            builder->text(std::string(at(seq)))
+                ->color([color = settings.color]() { return color; })
+                ->fontSize(CFontSize(settings.fontSize))
+                ->clampSize(Vector2D{width, settings.lineHeight});
+            if (!settings.fontFamily.empty())
+                builder->fontFamily(std::string(settings.fontFamily));
+            row = builder->commence();
+
+            if (!recycled) {
+                row->setPositionMode(IElement::HT_POSITION_ABSOLUTE);
+                box->addChild(row);
+            }
+        }
+        row->setAbsolutePosition(Vector2D{0, (seq - first) * settings.lineHeight});
+    }
+
+    for (const auto& row : spare) {
+        box->removeChild(row);
+    }
+
+    laidOutSize = box->size();
+    refreshing  = false;
+}
+
+CLogViewElement::CLogViewElement(const SLogViewSettings& settings, CDynamicSize&& size) {
+    m_container = CNullBuilder::begin()->size(std::move(size))->commence();
+
+    m_state            = makeShared<SLogViewState>();
+    m_state->settings  = settings;
+    m_state->container = CSharedPointer<IElement>(m_container);
+    m_state->lines.reserve(std::min<size_t>(settings.capacity, 4096));
+
+    // More or fewer rows fit after a resize
+    m_container->setRepositioned([state = m_state]() {
+        auto container = state->container.lock();
+        if (container && !(container->size() == state->laidOutSize))
+            scheduleRefresh(state);
+    });
+}
+
+void CLogViewElement::changed() {
+    scheduleRefresh(m_state);
+}
+
+void CLogViewElement::append(std::string_view text) {
+    if (text.ends_with('\n'))
+        text.remove_suffix(1);
+
+    while (true) {
+        const auto nl = text.find('\n');
+        m_state->push(text.substr(0, nl));
+        if (nl == std::string_view::npos)
+            break;
+        text.remove_prefix(nl + 1);
+    }
+    changed();
+}
+
+void CLogViewElement::clear() {
+    m_state->lines.clear();
+    m_state->head     = 0;
+    m_state->firstSeq = m_state->nextSeq;
+    m_state->top      = m_state->nextSeq;
+    changed();
+}
+
+size_t CLogViewElement::lineCount() const {
+    return m_state->count();
+}
+
+uint64_t CLogViewElement::dropped() const {
+    return m_state->firstSeq;
+}
+
+std::optional<std::string> CLogViewElement::line(size_t index) const {
+    if (index == 0 || index > m_state->count())
+        return std::nullopt;
+    return m_state->at(m_state->firstSeq + index - 1);
+}
+
+void CLogViewElement::scrollTo(size_t index) {
+    m_state->top    = m_state->firstSeq + (index ? index - 1 : 0);
+    m_state->follow = m_state->top + m_state->visibleRows() >= m_state->nextSeq;
+    changed();
+}
+
+void CLogViewElement::scrollBy(int64_t lines) {
+    const auto top = static_cast<int64_t>(m_state->topLine() - m_state->firstSeq) + lines;
+    scrollTo(static_cast<size_t>(std::max<int64_t>(top, 0)) + 1);
+}
+
+void CLogViewElement::scrollToBottom() {
+    m_state->follow = true;
+    changed();
+}
+
+bool CLogViewElement::following() const {
+    return m_state->follow;
+}
+
+std::vector<size_t> CLogViewElement::search(std::string_view needle, bool ignoreCase, size_t limit) const {
+    std::vector<size_t> found;
+    if (needle.empty())
+        return found;
+
+    CTracer::CSpan span("search", "logview");
+    auto           equalFolded = [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b)); };
+
+    for (size_t i = 0; i < m_state->count() && found.size() < limit; ++i) {
+        const std::string_view line = m_state->at(m_state->firstSeq + i);
+        const bool             hit  = ignoreCase ? std::search(line.begin(), line.end(), needle.begin(), needle.end(), equalFolded) != line.end() : line.find(needle) != std::string_view::npos;
+        if (hit)
+            found.push_back(i + 1);
+    }
+    return found;
+}
+
+Vector2D CLogViewElement::size() {
+    return m_container->size();
+}
+
+CSharedPointer<IElement> CLogViewElement::element() {
+    return CSharedPointer<IElement>(m_container);
+}
+
+CSharedPointer<CLogViewBuilder> CLogViewBuilder::begin() {
+    auto builder    = CSharedPointer<CLogViewBuilder>(new CLogViewBuilder());
+    builder->m_self = builder;
+    return builder;
+}
+
+CSharedPointer<CLogViewBuilder> CLogViewBuilder::capacity(size_t lines) {
+    m_settings.capacity = std::max<size_t>(1, lines);
+    return m_self.lock();
+}
+
+CSharedPointer<CLogViewBuilder> CLogViewBuilder::lineHeight(double height) {
+    m_settings.lineHeight = std::max(1.0, height);
+    return m_self.lock();
+}
+
+CSharedPointer<CLogViewBuilder> CLogViewBuilder::color(CHyprColor&& color) {
+    m_settings.color = color;
+    return m_self.lock();
+}
+
+CSharedPointer<CLogViewBuilder> CLogViewBuilder::fontSize(CFontSize&& size) {
+    m_settings.fontSize = size;
+    return m_self.lock();
+}
+
+CSharedPointer<CLogViewBuilder> CLogViewBuilder::fontFamily(std::string&& family) {
+    m_settings.fontFamily = std::move(family);
+    return m_self.lock();
+}
+
+CSharedPointer<CLogViewBuilder> CLogViewBuilder::size(CDynamicSize&& size) {
+    m_size = std::move(size);
+    return m_self.lock();
+}
+
+CSharedPointer<CLogViewElement> CLogViewBuilder::commence() {
+    return makeShared<CLogViewElement>(m_settings, m_size.value_or(fillParent()));
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <hyprtoolkit/element/Element.hpp>
+#include <hyprtoolkit/element/Null.hpp>
+#include <hyprtoolkit/element/Text.hpp>
+#include <hyprtoolkit/palette/Color.hpp>
+#include <hyprtoolkit/types/FontTypes.hpp>
+#include <hyprtoolkit/types/SizeType.hpp>
+#include <hyprutils/math/Vector2D.hpp>
+#include <hyprutils/memory/SharedPtr.hpp>
+#include <hyprutils/memory/WeakPtr.hpp>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Append-only log console. Lines live in a bounded ring in C++; the view is a pool of
+// CTextElements, one per visible row, that show whichever lines are on screen. Appends
+// only mark the view dirty and one idle pass per frame updates it, so a burst of
+// thousands of lines costs at most one rebuild per visible row.
+
+namespace Hyprtoolkit::Lua {
+
+struct SLogViewSettings {
+    size_t      capacity   = 10000;
+    double      lineHeight = 18;
+    CHyprColor  color      = CHyprColor(1, 1, 1, 1);
+    CFontSize   fontSize{CFontSize::HT_FONT_TEXT, 1.F};
+    std::string fontFamily;
+};
+
+// Owned by the container's repositioned callback, like the canvas
+struct SLogViewState {
+    using RowMap = std::unordered_map<uint64_t, Hyprutils::Memory::CSharedPointer<CTextElement>>;
+
+    SLogViewSettings                          settings;
+    Hyprutils::Memory::CWeakPointer<IElement> container;
+
+    // Ring of the last `capacity` lines; seq numbers count every line ever appended
+    std::vector<std::string>                  lines;
+    size_t                                    head     = 0; // slot of the oldest line
+    uint64_t                                  firstSeq = 0;
+    uint64_t                                  nextSeq  = 0;
+
+    // Seq of the top row while not following
+    uint64_t                                  top    = 0;
+    bool                                      follow = true;
+
+    // Visible rows by the seq they show, so scrolling moves rows instead of rebuilding them
+    RowMap                                    rows;
+    Hyprutils::Math::Vector2D                 laidOutSize;
+    bool                                      scheduled  = false;
+    bool                                      refreshing = false;
+
+    size_t                                    count() const;
+    const std::string&                        at(uint64_t seq) const;
+    void                                      push(std::string_view line);
+    size_t                                    visibleRows() const;
+    // Seq of the first visible line, following or clamped to the held lines
+    uint64_t                                  topLine() const;
+    void                                      refresh();
+};
+
+class CLogViewElement {
+  public:
+    CLogViewElement(const SLogViewSettings& settings, CDynamicSize&& size);
+
+    // Splits on newlines; evicts the oldest lines past capacity
+    void                                        append(std::string_view text);
+    void                                        clear();
+
+    // Lines currently held, and how many were evicted so far
+    size_t                                      lineCount() const;
+    uint64_t                                    dropped() const;
+    // 1-based, oldest first
+    std::optional<std::string>                  line(size_t index) const;
+
+    // Scrolling by line; scrolling to the bottom resumes following new lines
+    void                                        scrollTo(size_t index);
+    void                                        scrollBy(int64_t lines);
+    void                                        scrollToBottom();
+    bool                                        following() const;
+
+    // 1-based indices of lines containing needle, oldest first, at most `limit`
+    std::vector<size_t>                         search(std::string_view needle, bool ignoreCase, size_t limit) const;
+
+    Hyprutils::Math::Vector2D                   size();
+    Hyprutils::Memory::CSharedPointer<IElement> element();
+
+  private:
+    void                                        changed();
+
+    Hyprutils::Memory::CSharedPointer<CNullElement>  m_container;
+    Hyprutils::Memory::CSharedPointer<SLogViewState> m_state;
+};
+
+class CLogViewBuilder {
+  public:
+    static Hyprutils::Memory::CSharedPointer<CLogViewBuilder> begin();
+
+    // Lines kept before the oldest are dropped
+    Hyprutils::Memory::CSharedPointer<CLogViewBuilder>        capacity(size_t lines);
+    Hyprutils::Memory::CSharedPointer<CLogViewBuilder>        lineHeight(double height);
+    Hyprutils::Memory::CSharedPointer<CLogViewBuilder>        color(CHyprColor&& color);
+    Hyprutils::Memory::CSharedPointer<CLogViewBuilder>        fontSize(CFontSize&& size);
+    Hyprutils::Memory::CSharedPointer<CLogViewBuilder>        fontFamily(std::string&& family);
+    Hyprutils::Memory::CSharedPointer<CLogViewBuilder>        size(CDynamicSize&& size);
+
+    Hyprutils::Memory::CSharedPointer<CLogViewElement>        commence();
+
+  private:
+    Hyprutils::Memory::CWeakPointer<CLogViewBuilder>          m_self;
+    SLogViewSettings                                          m_settings;
+    std::optional<CDynamicSize>                               m_size;
+};
+
+} // namespace Hyprtoolkit::Lua
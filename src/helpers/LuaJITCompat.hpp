@@ -0,0 +1,196 @@
+#pragma once
+
+namespace Hyprtoolkit::Lua {
+
+// Lua 5.4 library functions missing from LuaJIT, run once after openLibs.
+// Syntax-level features cannot be shimmed: `//`, bitwise operators and
+// <const>/<close> still need LuaJIT-compatible spellings (math.floor(a / b),
+// the bit library). goto is supported natively by LuaJIT 2.x.
+// Integers are doubles under LuaJIT, so math.maxinteger is 2^53.
+inline constexpr const char* LUAJIT_COMPAT_PRELUDE = R"lua(
+table.unpack = table.unpack or unpack
+table.pack = table.pack or function(...)
+    return { n = select("#", ...), ... }
+end
+table.move = table.move or function(a1, f, e, t, a2)
+    a2 = a2 or a1
+    if e < f then
+        return a2
+    end
+    if t > f and t <= e and a1 == a2 then
+        for i = e - f, 0, -1 do
+            a2[t + i] = a1[f + i]
+        end
+    else
+        for i = 0, e - f do
+            a2[t + i] = a1[f + i]
+        end
+    end
+    return a2
+end
+
+math.maxinteger = math.maxinteger or 2 ^ 53
+math.mininteger = math.mininteger or -2 ^ 53
+math.tointeger = math.tointeger or function(x)
+    if type(x) == "number" and x == math.floor(x) and x >= math.mininteger and x <= math.maxinteger then
+        return x
+    end
+    return nil
+end
+math.type = math.type or function(x)
+    if type(x) ~= "number" then
+        return nil
+    end
+    return (x == math.floor(x) and x >= math.mininteger and x <= math.maxinteger) and "integer" or "float"
+end
+
+if utf8 == nil then
+    local utf8 = {}
+    utf8.charpattern = "[%z\1-\127\194-\244][\128-\191]*"
+
+    local function encode(c)
+        if c < 0 or c > 0x10FFFF then
+            error("value out of range", 3)
+        end
+        if c < 0x80 then
+            return string.char(c)
+        elseif c < 0x800 then
+            return string.char(0xC0 + math.floor(c / 0x40), 0x80 + c % 0x40)
+        elseif c < 0x10000 then
+            return string.char(0xE0 + math.floor(c / 0x1000), 0x80 + math.floor(c / 0x40) % 0x40, 0x80 + c % 0x40)
+        end
+        return string.char(0xF0 + math.floor(c / 0x40000), 0x80 + math.floor(c / 0x1000) % 0x40, 0x80 + math.floor(c / 0x40) % 0x40, 0x80 + c % 0x40)
+    end
+
+    -- codepoint, byte length of the sequence at i, or nil if it is malformed
+    local function decode(s, i)
+        local c = s:byte(i)
+        if not c then
+            return nil
+        end
+        if c < 0x80 then
+            return c, 1
+        end
+        local n = (c >= 0xC2 and c < 0xE0 and 2) or (c >= 0xE0 and c < 0xF0 and 3) or (c >= 0xF0 and c < 0xF5 and 4) or nil
+        if not n then
+            return nil
+        end
+        local cp = c % (2 ^ (7 - n))
+        for k = 1, n - 1 do
+            local b = s:byte(i + k)
+            if not b or b < 0x80 or b > 0xBF then
+                return nil
+            end
+            cp = cp * 0x40 + b % 0x40
+        end
+        return cp, n
+    end
+
+    local function isContinuation(s, i)
+        local b = s:byte(i)
+        return b ~= nil and b >= 0x80 and b <= 0xBF
+    end
+
+    local function position(i, len)
+        if i < 0 then
+            return len + i + 1
+        end
+        return i
+    end
+
+    function utf8.char(...)
+        local out = {}
+        for i = 1, select("#", ...) do
+            out[i] = encode(select(i, ...))
+        end
+        return table.concat(out)
+    end
+
+    function utf8.codepoint(s, i, j)
+        i = position(i or 1, #s)
+        j = position(j or i, #s)
+        local out = {}
+        while i <= j do
+            local cp, n = decode(s, i)
+            if not cp then
+                error("invalid UTF-8 code", 2)
+            end
+            out[#out + 1] = cp
+            i = i + n
+        end
+        return unpack(out)
+    end
+
+    function utf8.len(s, i, j)
+        i = position(i or 1, #s)
+        j = position(j or -1, #s)
+        local count = 0
+        while i <= j do
+            local _, n = decode(s, i)
+            if not n then
+                return nil, i
+            end
+            count = count + 1
+            i = i + n
+        end
+        return count
+    end
+
+    function utf8.offset(s, n, i)
+        local len = #s
+        i = position(i or (n >= 0 and 1 or len + 1), len)
+        if n == 0 then
+            while i > 1 and isContinuation(s, i) do
+                i = i - 1
+            end
+            return i
+        end
+        if isContinuation(s, i) then
+            error("initial position is a continuation byte", 2)
+        end
+        if n > 0 then
+            n = n - 1
+            while n > 0 and i <= len do
+                i = i + 1
+                while isContinuation(s, i) do
+                    i = i + 1
+                end
+                n = n - 1
+            end
+        else
+            while n < 0 and i > 1 do
+                i = i - 1
+                while i > 1 and isContinuation(s, i) do
+                    i = i - 1
+                end
+                n = n + 1
+            end
+        end
+        if n == 0 then
+            return i
+        end
+        return nil
+    end
+
+    function utf8.codes(s)
+        local i = 1
+        return function()
+            if i > #s then
+                return nil
+            end
+            local cp, n = decode(s, i)
+            if not cp then
+                error("invalid UTF-8 code", 2)
+            end
+            local p = i
+            i = i + n
+            return p, cp
+        end
+    end
+
+    _G.utf8 = utf8
+    package.loaded.utf8 = utf8
+end
+)lua";
+
+} // namespace Hyprtoolkit::Lua
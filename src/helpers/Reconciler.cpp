@@ -0,0 +1,294 @@
+#include "Reconciler.hpp"
+
+#include <hyprtoolkit-lua/Tracer.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+#include "ElementAdapter.hpp"
+
+using namespace Hyprutils::Memory;
+
+namespace Hyprtoolkit::Lua {
+
+std::unordered_map<std::string, SReconcileType>& reconcileTypes() {
+    static std::unordered_map<std::string, SReconcileType> types;
+    return types;
+}
+
+// Grid and flow layouts lay out what is added through them, not through their container
+static void addChildTo(const sol::object& parent, const CSharedPointer<IElement>& child) {
+    if (parent.is<CSharedPointer<CGridLayoutElement>>())
+        parent.as<CSharedPointer<CGridLayoutElement>>()->addChild(child);
+    else if (parent.is<CSharedPointer<CFlowLayoutElement>>())
+        parent.as<CSharedPointer<CFlowLayoutElement>>()->addChild(child);
+    else if (auto element = elementFromLua(parent))
+        element->addChild(child);
+    else
+        throw std::runtime_error("render: container is not an element");
+}
+
+static void removeChildFrom(const sol::object& parent, const CSharedPointer<IElement>& child) {
+    if (parent.is<CSharedPointer<CGridLayoutElement>>())
+        parent.as<CSharedPointer<CGridLayoutElement>>()->removeChild(child);
+    else if (parent.is<CSharedPointer<CFlowLayoutElement>>())
+        parent.as<CSharedPointer<CFlowLayoutElement>>()->removeChild(child);
+    else if (auto element = elementFromLua(parent))
+        element->removeChild(child);
+}
+
+// Value equality for props: primitives and userdata through ==, so usertypes with
+// operator== (colors, sizes) compare by value; plain tables one level deep by content
+static bool sameValue(const sol::object& a, const sol::object& b, int depth = 0) {
+    if (a.get_type() != b.get_type())
+        return false;
+
+    if (a.get_type() == sol::type::lua_nil)
+        return true;
+
+    if (a.get_type() == sol::type::table && depth < 2) {
+        sol::table ta = a, tb = b;
+        size_t     countA = 0, countB = 0;
+        for (const auto& [key, value] : ta) {
+            if (!sameValue(value, tb.get<sol::object>(key), depth + 1))
+                return false;
+            ++countA;
+        }
+        for ([[maybe_unused]] const auto& entry : tb) {
+            ++countB;
+        }
+        return countA == countB;
+    }
+
+    lua_State* L = a.lua_state();
+    a.push(L);
+    b.push(L);
+#ifdef HYPRTOOLKIT_LUA_LUAJIT
+    const bool equal = lua_equal(L, -1, -2);
+#else
+    const bool equal = lua_compare(L, -1, -2, LUA_OPEQ);
+#endif
+    lua_pop(L, 2);
+    return equal;
+}
+
+static sol::table copyTable(sol::state_view lua, const sol::optional<sol::table>& from) {
+    sol::table copy = lua.create_table();
+    if (from) {
+        for (const auto& [key, value] : *from) {
+            copy[key] = value;
+        }
+    }
+    return copy;
+}
+
+static std::string keyString(const sol::object& key, std::string fallback) {
+    if (key.get_type() == sol::type::string)
+        return key.as<std::string>();
+    if (key.get_type() == sol::type::number)
+        return std::to_string(key.as<double>());
+    return fallback;
+}
+
+// Unkeyed nodes match by position
+static std::string keyOf(const sol::table& description, size_t index) {
+    return keyString(description["key"], "#" + std::to_string(index));
+}
+
+CReconciler::CReconciler(sol::object container) : m_container(std::move(container)) {
+    if (!elementFromLua(m_container))
+        throw std::runtime_error("Reconciler.create: container is not an element");
+
+    sol::state_view lua(m_container.lua_state());
+    m_trampolineFactory = lua.load(R"lua(
+        local handlers, name = ...
+        return function(...)
+            local fn = handlers[name]
+            if fn then
+                return fn(...)
+            end
+        end
+    )lua", "=reconciler");
+}
+
+sol::object CReconciler::trampoline(const sol::table& handlers, const std::string& name) {
+    sol::protected_function_result result = m_trampolineFactory(handlers, name);
+    return result.get<sol::object>();
+}
+
+void CReconciler::render(sol::object description) {
+    CTracer::CSpan span("render", "reconciler");
+    m_stats = {};
+
+    // A single node is the only child
+    if (description.is<sol::table>() && description.as<sol::table>()["type"].valid()) {
+        sol::state_view lua(description.lua_state());
+        description = sol::make_object(lua, lua.create_table_with(1, description));
+    }
+
+    reconcile(m_container, m_nodes, description);
+}
+
+void CReconciler::clear() {
+    for (const auto& node : m_nodes) {
+        removeChildFrom(m_container, node->attached);
+    }
+    m_nodes.clear();
+}
+
+void CReconciler::reconcile(const sol::object& parent, NodeList& nodes, const sol::object& descriptions) {
+    sol::table list;
+    if (descriptions.is<sol::table>())
+        list = descriptions.as<sol::table>();
+    else if (descriptions.valid() && descriptions.get_type() != sol::type::lua_nil)
+        throw std::runtime_error("render: children must be a list of descriptions");
+
+    std::unordered_map<std::string, size_t> byKey;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        byKey.emplace(nodes[i]->key, i);
+    }
+
+    NodeList          next;
+    std::vector<bool> kept(nodes.size(), false);
+    const size_t      count = list.valid() ? list.size() : 0;
+    next.reserve(count);
+
+    for (size_t i = 1; i <= count; ++i) {
+        sol::optional<sol::table> description = list[i];
+        if (!description)
+            throw std::runtime_error("render: child " + std::to_string(i) + " is not a description table");
+
+        auto                           key  = keyOf(*description, i);
+        const auto                     type = description->get_or<std::string>("type", "");
+        CSharedPointer<SReconcileNode> node;
+
+        if (auto it = byKey.find(key); it != byKey.end() && !kept[it->second] && nodes[it->second]->type == type && patch(*nodes[it->second], *description)) {
+            node             = nodes[it->second];
+            kept[it->second] = true;
+        } else
+            node = create(*description, std::move(key));
+
+        next.push_back(node);
+    }
+
+    NodeList survivors;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (kept[i])
+            survivors.push_back(nodes[i]);
+        else {
+            removeChildFrom(parent, nodes[i]->attached);
+            ++m_stats.removed;
+        }
+    }
+
+    // Containers only append, so everything after the first out-of-place child is
+    // re-appended in order. Appending, removing and updating never move anything.
+    size_t inPlace = 0;
+    while (inPlace < survivors.size() && inPlace < next.size() && survivors[inPlace] == next[inPlace]) {
+        ++inPlace;
+    }
+    for (size_t i = inPlace; i < survivors.size(); ++i) {
+        removeChildFrom(parent, survivors[i]->attached);
+        ++m_stats.moved;
+    }
+    for (size_t i = inPlace; i < next.size(); ++i) {
+        addChildTo(parent, next[i]->attached);
+    }
+
+    nodes = std::move(next);
+}
+
+CSharedPointer<SReconcileNode> CReconciler::create(const sol::table& description, std::string key) {
+    const auto type = description.get_or<std::string>("type", "");
+    auto       it   = reconcileTypes().find(type);
+    if (it == reconcileTypes().end())
+        throw std::runtime_error("render: unknown element type '" + type + "'");
+
+    sol::state_view lua(description.lua_state());
+    auto            node = makeShared<SReconcileNode>();
+    node->type           = type;
+    node->key            = std::move(key);
+    node->kind           = &it->second;
+    node->props          = copyTable(lua, description.get<sol::optional<sol::table>>("props"));
+    node->handlers       = lua.create_table();
+
+    sol::table initial = lua.create_table();
+    for (const auto& [name, value] : node->props) {
+        const auto prop = name.as<std::string>();
+        if (node->kind->events.contains(prop)) {
+            node->handlers[prop] = value;
+            initial[prop]        = trampoline(node->handlers, prop);
+            node->boundEvents.insert(prop);
+        } else
+            initial[prop] = value;
+    }
+
+    node->element  = node->kind->create(lua, initial);
+    node->attached = elementFromLua(node->element);
+    ++m_stats.created;
+
+    reconcile(node->element, node->children, description["children"]);
+    return node;
+}
+
+bool CReconciler::patch(SReconcileNode& node, const sol::table& description) {
+    sol::state_view lua(description.lua_state());
+    sol::table      props   = copyTable(lua, description.get<sol::optional<sol::table>>("props"));
+    sol::table      changed = lua.create_table();
+    bool            dirty   = false;
+
+    // Builders can't unset a property, a removed one means a fresh element
+    for (const auto& [name, value] : node.props) {
+        if (!props[name].valid())
+            return false;
+    }
+
+    for (const auto& [name, value] : props) {
+        const auto prop = name.as<std::string>();
+        if (node.kind->events.contains(prop)) {
+            node.handlers[prop] = value;
+            if (node.boundEvents.contains(prop))
+                continue;
+            changed[prop] = trampoline(node.handlers, prop);
+            dirty         = true;
+        } else if (!sameValue(node.props.get<sol::object>(name), value)) {
+            changed[prop] = value;
+            dirty         = true;
+        }
+    }
+
+    if (dirty) {
+        if (!node.kind->update)
+            return false;
+        node.kind->update(node.element, changed);
+        for (const auto& [name, value] : changed) {
+            if (node.kind->events.contains(name.as<std::string>()))
+                node.boundEvents.insert(name.as<std::string>());
+        }
+        ++m_stats.updated;
+    } else
+        ++m_stats.unchanged;
+
+    node.props = props;
+    reconcile(node.element, node.children, description["children"]);
+    return true;
+}
+
+sol::object CReconciler::find(sol::this_state s, sol::variadic_args path) const {
+    const NodeList* nodes = &m_nodes;
+    sol::object     found = sol::make_object(s, sol::lua_nil);
+    for (const auto& segment : path) {
+        const auto key = keyString(segment, "");
+        const auto it  = std::ranges::find_if(*nodes, [&key](const auto& node) { return node->key == key; });
+        if (it == nodes->end())
+            return sol::make_object(s, sol::lua_nil);
+        found = (*it)->element;
+        nodes = &(*it)->children;
+    }
+    return found;
+}
+
+const SReconcileStats& CReconciler::stats() const {
+    return m_stats;
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <sol/sol.hpp>
+#include <hyprtoolkit/element/Element.hpp>
+#include <hyprutils/memory/SharedPtr.hpp>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Keyed reconciliation of description trees against live elements. A description is
+//   { type = "CText", key = "clock", props = { text = "12:00" }, children = { ... } }
+// render() diffs it against the previous one and only creates, rebuilds, removes or
+// re-appends what changed. Events are bound once to a trampoline reading the latest
+// handler, so fresh closures on every render don't rebuild anything.
+
+namespace Hyprtoolkit::Lua {
+
+// What the reconciler needs to know about one element type, filled in by
+// registerElementType from the element's SElementDesc
+struct SReconcileType {
+    // Builds an element from a props table, returns the element userdata
+    std::function<sol::object(sol::state_view, const sol::table& props)>     create;
+    // Applies changed props in place through rebuild(); empty for types without one
+    std::function<void(const sol::object& element, const sol::table& props)> update;
+    std::unordered_set<std::string>                                          events;
+};
+
+// By builder name ("CTextBuilder") and short name ("CText")
+std::unordered_map<std::string, SReconcileType>& reconcileTypes();
+
+struct SReconcileStats {
+    size_t created   = 0;
+    size_t updated   = 0;
+    size_t removed   = 0;
+    size_t moved     = 0;
+    size_t unchanged = 0;
+};
+
+struct SReconcileNode {
+    std::string                                                    type;
+    std::string                                                    key;
+    const SReconcileType*                                          kind = nullptr;
+    sol::object                                                    element;
+    Hyprutils::Memory::CSharedPointer<IElement>                    attached; // what the parent holds
+    sol::table                                                     props;
+    sol::table                                                     handlers;
+    std::unordered_set<std::string>                                boundEvents;
+    std::vector<Hyprutils::Memory::CSharedPointer<SReconcileNode>> children;
+};
+
+class CReconciler {
+  public:
+    // container: any element that takes children, including grid and flow layouts
+    explicit CReconciler(sol::object container);
+
+    // One description or a list of them, as the container's children
+    void                   render(sol::object description);
+    void                   clear();
+
+    // Element rendered under a key, e.g. find("sidebar", "clock"); nil if none
+    sol::object            find(sol::this_state s, sol::variadic_args path) const;
+
+    const SReconcileStats& stats() const;
+
+  private:
+    using NodeList = std::vector<Hyprutils::Memory::CSharedPointer<SReconcileNode>>;
+
+    void                                              reconcile(const sol::object& parent, NodeList& nodes, const sol::object& descriptions);
+    Hyprutils::Memory::CSharedPointer<SReconcileNode> create(const sol::table& description, std::string key);
+    bool                                              patch(SReconcileNode& node, const sol::table& description);
+    sol::object                                       trampoline(const sol::table& handlers, const std::string& name);
+
+    sol::object                                       m_container;
+    NodeList                                          m_nodes;
+    SReconcileStats                                   m_stats;
+    sol::protected_function                           m_trampolineFactory;
+};
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <sol/sol.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Hyprtoolkit::Lua {
+
+// A Lua function pinned in the registry by a C++ callback
+struct SPinnedRef {
+    lua_State*  state = nullptr; // main thread of the owning state
+    int         ref   = LUA_NOREF;
+    const void* owner = nullptr; // builder, element or window the callback belongs to
+    const char* type  = nullptr; // usertype it was registered through, e.g. "CButtonBuilder"
+    const char* event = nullptr; // method it was registered with, e.g. "onMainClick"
+};
+
+// Process-wide table of every Lua function currently pinned by a binding callback.
+// Entries live exactly as long as the C++ side keeps the closure alive, so this
+// shows whether removeChild/clearChildren really release a subtree's closures.
+class CRefTracker {
+  public:
+    static CRefTracker& get() {
+        static CRefTracker tracker;
+        return tracker;
+    }
+
+    uint64_t add(const SPinnedRef& ref) {
+        const auto id = m_nextID++;
+        m_refs.emplace(id, ref);
+        m_byOwner[ref.owner].push_back(id);
+        return id;
+    }
+
+    void remove(uint64_t id) {
+        const auto it = m_refs.find(id);
+        if (it == m_refs.end())
+            return;
+
+        const auto owner = m_byOwner.find(it->second.owner);
+        if (owner != m_byOwner.end()) {
+            std::erase(owner->second, id);
+            if (owner->second.empty())
+                m_byOwner.erase(owner);
+        }
+
+        m_refs.erase(it);
+    }
+
+    // Attribute everything pinned by `from` to `to` (builder -> commenced element).
+    // With `since`, only refs added from that id on move, e.g. the copies a prototype
+    // made for one instance.
+    void retarget(const void* from, const void* to, uint64_t since = 0) {
+        if (from == to)
+            return;
+
+        const auto it = m_byOwner.find(from);
+        if (it == m_byOwner.end())
+            return;
+
+        auto& target = m_byOwner[to];
+        std::erase_if(it->second, [&](uint64_t id) {
+            if (id < since)
+                return false;
+            m_refs[id].owner = to;
+            target.push_back(id);
+            return true;
+        });
+
+        if (it->second.empty())
+            m_byOwner.erase(it);
+    }
+
+    // Id the next add() will get, for retarget(..., since)
+    uint64_t nextID() const {
+        return m_nextID;
+    }
+
+    const std::unordered_map<uint64_t, SPinnedRef>& refs() const {
+        return m_refs;
+    }
+
+    const std::unordered_map<const void*, std::vector<uint64_t>>& owners() const {
+        return m_byOwner;
+    }
+
+  private:
+    std::unordered_map<uint64_t, SPinnedRef>               m_refs;
+    std::unordered_map<const void*, std::vector<uint64_t>> m_byOwner;
+    uint64_t                                               m_nextID = 1;
+};
+
+// A protected Lua function registered with CRefTracker for as long as it exists.
+// Every copy holds its own registry reference, so every copy is tracked.
+class CLuaFunctionRef {
+  public:
+    CLuaFunctionRef(sol::protected_function fn, const void* owner, const char* type, const char* event) :
+        m_fn(std::move(fn)), m_owner(owner), m_type(type), m_event(event) {
+        track();
+    }
+
+    CLuaFunctionRef(const CLuaFunctionRef& other) : m_fn(other.m_fn), m_owner(other.m_owner), m_type(other.m_type), m_event(other.m_event) {
+        track();
+    }
+
+    CLuaFunctionRef(CLuaFunctionRef&& other) noexcept :
+        m_fn(std::move(other.m_fn)), m_owner(other.m_owner), m_type(other.m_type), m_event(other.m_event), m_id(std::exchange(other.m_id, 0)) {}
+
+    CLuaFunctionRef& operator=(const CLuaFunctionRef&) = delete;
+    CLuaFunctionRef& operator=(CLuaFunctionRef&&)      = delete;
+
+    ~CLuaFunctionRef() {
+        if (m_id)
+            CRefTracker::get().remove(m_id);
+    }
+
+    template <typename... Args>
+    sol::protected_function_result operator()(Args&&... args) const {
+        return m_fn(std::forward<Args>(args)...);
+    }
+
+    const sol::protected_function& function() const {
+        return m_fn;
+    }
+
+    const char* type() const {
+        return m_type;
+    }
+
+    const char* event() const {
+        return m_event;
+    }
+
+  private:
+    void track() {
+        if (!m_fn.valid())
+            return;
+
+        m_id = CRefTracker::get().add(SPinnedRef{
+            .state = sol::main_thread(m_fn.lua_state(), m_fn.lua_state()),
+            .ref   = m_fn.registry_index(),
+            .owner = m_owner,
+            .type  = m_type,
+            .event = m_event,
+        });
+    }
+
+    sol::protected_function m_fn;
+    const void*             m_owner = nullptr;
+    const char*             m_type  = nullptr;
+    const char*             m_event = nullptr;
+    uint64_t                m_id    = 0;
+};
+
+} // namespace Hyprtoolkit::Lua
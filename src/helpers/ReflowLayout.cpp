@@ -0,0 +1,212 @@
+#include "ReflowLayout.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Async.hpp"
+
+using namespace Hyprutils::Memory;
+using namespace Hyprutils::Math;
+
+namespace Hyprtoolkit::Lua {
+
+static CDynamicSize defaultLayoutSize() {
+    return CDynamicSize(CDynamicSize::HT_SIZE_PERCENT, CDynamicSize::HT_SIZE_PERCENT, {1, 1});
+}
+
+// Reposition the container once the current pass is over; its repositioned callback
+// then reflows with up to date child sizes
+static void scheduleReflow(const CSharedPointer<SReflowState>& state) {
+    auto backend = CMainQueue::get().backend();
+    if (!backend || state->scheduled)
+        return;
+
+    state->scheduled = true;
+    backend->addIdle([weak = CWeakPointer<SReflowState>(state)]() {
+        auto state = weak.lock();
+        if (!state)
+            return;
+
+        state->scheduled = false;
+        if (auto container = state->container.lock())
+            container->forceReposition();
+    });
+}
+
+bool SReflowState::reflow() {
+    auto box = container.lock();
+    if (!box || reflowing)
+        return false;
+
+    reflowing = true;
+    std::erase_if(children, [](const auto& child) { return child.expired(); });
+    positions.resize(children.size(), Vector2D{-1, -1});
+
+    const double width      = box->size().x;
+    Vector2D     cursor     = {0, 0};
+    double       lineHeight = 0;
+    double       right      = 0;
+    bool         moved      = false;
+    size_t       cols       = 1;
+    double       cellWidth  = 0;
+
+    if (settings.mode == REFLOW_GRID) {
+        cols = settings.columns ? settings.columns :
+                                  static_cast<size_t>(std::max(1.0, std::floor((width + settings.gap) / std::max(1.0, settings.minCellWidth + settings.gap))));
+        cellWidth   = std::max(0.0, (width - settings.gap * (cols - 1)) / cols);
+        columnsUsed = cols;
+    }
+
+    for (size_t i = 0; i < children.size(); ++i) {
+        auto       child = children[i].lock();
+        const auto size  = child->size();
+
+        bool newLine = false;
+        if (settings.mode == REFLOW_GRID)
+            newLine = i > 0 && i % cols == 0;
+        else
+            newLine = cursor.x > 0 && cursor.x + size.x > width;
+
+        if (newLine) {
+            cursor     = {0, cursor.y + lineHeight + settings.rowGap};
+            lineHeight = 0;
+        }
+
+        const Vector2D pos = settings.mode == REFLOW_GRID ? Vector2D{(i % cols) * (cellWidth + settings.gap), cursor.y} : cursor;
+        if (!(positions[i] == pos)) {
+            child->setAbsolutePosition(pos);
+            positions[i] = pos;
+            moved        = true;
+        }
+
+        cursor.x   = pos.x + (settings.mode == REFLOW_GRID ? cellWidth : size.x) + settings.gap;
+        lineHeight = std::max(lineHeight, size.y);
+        right      = std::max(right, pos.x + (settings.mode == REFLOW_GRID ? cellWidth : size.x));
+    }
+
+    contentSize = children.empty() ? Vector2D{0, 0} : Vector2D{right, cursor.y + lineHeight};
+    reflowing   = false;
+    return moved;
+}
+
+CReflowLayoutElement::CReflowLayoutElement(const SReflowSettings& settings, CDynamicSize&& size) {
+    m_container = CNullBuilder::begin()->size(std::move(size))->commence();
+
+    m_state            = makeShared<SReflowState>();
+    m_state->settings  = settings;
+    m_state->container = CSharedPointer<IElement>(m_container);
+
+    // Moving a child repositions it; another pass picks up sizes that changed with it
+    m_container->setRepositioned([state = m_state]() {
+        if (state->reflow())
+            scheduleReflow(state);
+    });
+}
+
+void CReflowLayoutElement::addChild(CSharedPointer<IElement> child) {
+    child->setPositionMode(IElement::HT_POSITION_ABSOLUTE);
+    m_container->addChild(child);
+    m_state->children.emplace_back(child);
+    scheduleReflow(m_state);
+}
+
+void CReflowLayoutElement::removeChild(CSharedPointer<IElement> child) {
+    m_container->removeChild(child);
+    std::erase_if(m_state->children, [&](const auto& weak) { return weak.expired() || weak.lock() == child; });
+    m_state->positions.clear();
+    scheduleReflow(m_state);
+}
+
+void CReflowLayoutElement::clearChildren() {
+    m_container->clearChildren();
+    m_state->children.clear();
+    m_state->positions.clear();
+}
+
+void CReflowLayoutElement::reflow() {
+    if (m_state->reflow())
+        m_container->forceReposition();
+}
+
+Vector2D CReflowLayoutElement::size() {
+    return m_container->size();
+}
+
+Vector2D CReflowLayoutElement::contentSize() {
+    return m_state->contentSize;
+}
+
+CSharedPointer<IElement> CReflowLayoutElement::element() {
+    return CSharedPointer<IElement>(m_container);
+}
+
+void CGridLayoutElement::setColumns(size_t columns) {
+    m_state->settings.columns = columns;
+    scheduleReflow(m_state);
+}
+
+size_t CGridLayoutElement::columns() {
+    return m_state->columnsUsed;
+}
+
+CSharedPointer<CGridLayoutBuilder> CGridLayoutBuilder::begin() {
+    auto builder    = CSharedPointer<CGridLayoutBuilder>(new CGridLayoutBuilder());
+    builder->m_self = builder;
+    return builder;
+}
+
+CSharedPointer<CGridLayoutBuilder> CGridLayoutBuilder::columns(size_t columns) {
+    m_settings.columns = columns;
+    return m_self.lock();
+}
+
+CSharedPointer<CGridLayoutBuilder> CGridLayoutBuilder::minCellWidth(double width) {
+    m_settings.minCellWidth = width;
+    return m_self.lock();
+}
+
+CSharedPointer<CGridLayoutBuilder> CGridLayoutBuilder::gap(double gap) {
+    m_settings.gap = gap;
+    return m_self.lock();
+}
+
+CSharedPointer<CGridLayoutBuilder> CGridLayoutBuilder::rowGap(double gap) {
+    m_settings.rowGap = gap;
+    return m_self.lock();
+}
+
+CSharedPointer<CGridLayoutBuilder> CGridLayoutBuilder::size(CDynamicSize&& size) {
+    m_size = std::move(size);
+    return m_self.lock();
+}
+
+CSharedPointer<CGridLayoutElement> CGridLayoutBuilder::commence() {
+    return makeShared<CGridLayoutElement>(m_settings, m_size.value_or(defaultLayoutSize()));
+}
+
+CSharedPointer<CFlowLayoutBuilder> CFlowLayoutBuilder::begin() {
+    auto builder    = CSharedPointer<CFlowLayoutBuilder>(new CFlowLayoutBuilder());
+    builder->m_self = builder;
+    return builder;
+}
+
+CSharedPointer<CFlowLayoutBuilder> CFlowLayoutBuilder::gap(double gap) {
+    m_settings.gap = gap;
+    return m_self.lock();
+}
+
+CSharedPointer<CFlowLayoutBuilder> CFlowLayoutBuilder::rowGap(double gap) {
+    m_settings.rowGap = gap;
+    return m_self.lock();
+}
+
+CSharedPointer<CFlowLayoutBuilder> CFlowLayoutBuilder::size(CDynamicSize&& size) {
+    m_size = std::move(size);
+    return m_self.lock();
+}
+
+CSharedPointer<CFlowLayoutElement> CFlowLayoutBuilder::commence() {
+    return makeShared<CFlowLayoutElement>(m_settings, m_size.value_or(defaultLayoutSize()));
+}
+
+} // namespace Hyprtoolkit::Lua
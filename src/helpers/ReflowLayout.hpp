@@ -0,0 +1,121 @@
+#pragma once
+
+#include <hyprtoolkit/element/Element.hpp>
+#include <hyprtoolkit/element/Null.hpp>
+#include <hyprtoolkit/types/SizeType.hpp>
+#include <hyprutils/math/Vector2D.hpp>
+#include <hyprutils/memory/SharedPtr.hpp>
+#include <hyprutils/memory/WeakPtr.hpp>
+#include <optional>
+#include <vector>
+
+// Grid and flow layouts. hyprtoolkit has no public way to add element types, so a
+// layout is a CNullElement container whose children are absolutely positioned; the
+// container's repositioned callback recomputes their positions whenever its size or
+// the child list changes, so wrapping never goes through Lua.
+
+namespace Hyprtoolkit::Lua {
+
+enum eReflowMode : uint8_t {
+    REFLOW_GRID = 0,
+    REFLOW_FLOW,
+};
+
+struct SReflowSettings {
+    eReflowMode mode         = REFLOW_GRID;
+    size_t      columns      = 0; // grid: 0 = as many as minCellWidth allows
+    double      minCellWidth = 100;
+    double      gap          = 0;
+    double      rowGap       = 0;
+};
+
+// Owned by the container's repositioned callback, so the layout keeps working after
+// Lua drops its handle
+struct SReflowState {
+    SReflowSettings                                        settings;
+    Hyprutils::Memory::CWeakPointer<IElement>              container;
+    std::vector<Hyprutils::Memory::CWeakPointer<IElement>> children;
+    std::vector<Hyprutils::Math::Vector2D>                 positions;
+    Hyprutils::Math::Vector2D                              contentSize;
+    size_t                                                 columnsUsed = 0;
+    bool                                                   reflowing   = false;
+    bool                                                   scheduled   = false;
+
+    // Positions the children for the container's current size, true if any moved
+    bool                                                   reflow();
+};
+
+class CReflowLayoutElement {
+  public:
+    void                                        addChild(Hyprutils::Memory::CSharedPointer<IElement> child);
+    void                                        removeChild(Hyprutils::Memory::CSharedPointer<IElement> child);
+    void                                        clearChildren();
+
+    // Lays the children out now instead of on the next reposition
+    void                                        reflow();
+
+    Hyprutils::Math::Vector2D                   size();
+    // Extent of the laid out children, e.g. for sizing a scroll area's content
+    Hyprutils::Math::Vector2D                   contentSize();
+
+    // The container, for adding the layout to a parent
+    Hyprutils::Memory::CSharedPointer<IElement> element();
+
+  protected:
+    CReflowLayoutElement(const SReflowSettings& settings, CDynamicSize&& size);
+
+    Hyprutils::Memory::CSharedPointer<CNullElement> m_container;
+    Hyprutils::Memory::CSharedPointer<SReflowState> m_state;
+};
+
+class CGridLayoutElement : public CReflowLayoutElement {
+  public:
+    CGridLayoutElement(const SReflowSettings& settings, CDynamicSize&& size) : CReflowLayoutElement(settings, std::move(size)) {}
+
+    void   setColumns(size_t columns);
+    // Columns in the last layout pass, useful with auto columns
+    size_t columns();
+};
+
+class CFlowLayoutElement : public CReflowLayoutElement {
+  public:
+    CFlowLayoutElement(const SReflowSettings& settings, CDynamicSize&& size) : CReflowLayoutElement(settings, std::move(size)) {}
+};
+
+class CGridLayoutBuilder {
+  public:
+    static Hyprutils::Memory::CSharedPointer<CGridLayoutBuilder> begin();
+
+    // Fixed column count; without it columns are derived from minCellWidth
+    Hyprutils::Memory::CSharedPointer<CGridLayoutBuilder>        columns(size_t columns);
+    Hyprutils::Memory::CSharedPointer<CGridLayoutBuilder>        minCellWidth(double width);
+    Hyprutils::Memory::CSharedPointer<CGridLayoutBuilder>        gap(double gap);
+    Hyprutils::Memory::CSharedPointer<CGridLayoutBuilder>        rowGap(double gap);
+    Hyprutils::Memory::CSharedPointer<CGridLayoutBuilder>        size(CDynamicSize&& size);
+
+    Hyprutils::Memory::CSharedPointer<CGridLayoutElement>        commence();
+
+  private:
+    Hyprutils::Memory::CWeakPointer<CGridLayoutBuilder>          m_self;
+    SReflowSettings                                              m_settings = {.mode = REFLOW_GRID};
+    std::optional<CDynamicSize>                                  m_size;
+};
+
+class CFlowLayoutBuilder {
+  public:
+    static Hyprutils::Memory::CSharedPointer<CFlowLayoutBuilder> begin();
+
+    // Horizontal gap between items and vertical gap between lines
+    Hyprutils::Memory::CSharedPointer<CFlowLayoutBuilder>        gap(double gap);
+    Hyprutils::Memory::CSharedPointer<CFlowLayoutBuilder>        rowGap(double gap);
+    Hyprutils::Memory::CSharedPointer<CFlowLayoutBuilder>        size(CDynamicSize&& size);
+
+    Hyprutils::Memory::CSharedPointer<CFlowLayoutElement>        commence();
+
+  private:
+    Hyprutils::Memory::CWeakPointer<CFlowLayoutBuilder>          m_self;
+    SReflowSettings                                              m_settings = {.mode = REFLOW_FLOW};
+    std::optional<CDynamicSize>                                  m_size;
+};
+
+} // namespace Hyprtoolkit::Lua
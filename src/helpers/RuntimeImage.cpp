@@ -0,0 +1,148 @@
+#include "RuntimeImage.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+
+namespace Hyprtoolkit::Lua {
+
+static uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0) {
+    static const auto TABLE = [] {
+        std::array<uint32_t, 256> table;
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = c & 1 ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+        return table;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) {
+        crc = TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void appendBE32(std::string& out, uint32_t v) {
+    out += static_cast<char>(v >> 24);
+    out += static_cast<char>(v >> 16);
+    out += static_cast<char>(v >> 8);
+    out += static_cast<char>(v);
+}
+
+static void appendChunk(std::string& out, const char* type, const std::string& data) {
+    appendBE32(out, data.size());
+    const size_t start = out.size();
+    out.append(type, 4);
+    out += data;
+    appendBE32(out, crc32(reinterpret_cast<const uint8_t*>(out.data() + start), out.size() - start));
+}
+
+std::string encodePng(const uint32_t* pixels, int width, int height) {
+    std::string raw;
+    raw.reserve(static_cast<size_t>(height) * (1 + width * 4));
+    for (int y = 0; y < height; ++y) {
+        raw += '\0'; // filter: none
+        for (int x = 0; x < width; ++x) {
+            const uint32_t px = pixels[static_cast<size_t>(y) * width + x];
+            const uint32_t a  = px >> 24;
+            auto           un = [a](uint32_t v) { return static_cast<char>(a ? std::min<uint32_t>(255, (v * 255 + a / 2) / a) : 0); };
+            raw += un((px >> 16) & 0xFF);
+            raw += un((px >> 8) & 0xFF);
+            raw += un(px & 0xFF);
+            raw += static_cast<char>(a);
+        }
+    }
+
+    std::string zlib = "\x78\x01";
+    uint32_t    s1 = 1, s2 = 0;
+    for (size_t offset = 0;;) {
+        const size_t   len  = std::min<size_t>(65535, raw.size() - offset);
+        const bool     last = offset + len >= raw.size();
+        const uint16_t nlen = ~static_cast<uint16_t>(len);
+        zlib += static_cast<char>(last ? 1 : 0);
+        zlib += static_cast<char>(len & 0xFF);
+        zlib += static_cast<char>(len >> 8);
+        zlib += static_cast<char>(nlen & 0xFF);
+        zlib += static_cast<char>(nlen >> 8);
+        zlib.append(raw, offset, len);
+        offset += len;
+        if (last)
+            break;
+    }
+    for (const char c : raw) {
+        s1 = (s1 + static_cast<uint8_t>(c)) % 65521;
+        s2 = (s2 + s1) % 65521;
+    }
+    appendBE32(zlib, (s2 << 16) | s1);
+
+    std::string header;
+    appendBE32(header, width);
+    appendBE32(header, height);
+    header.append("\x08\x06\x00\x00\x00", 5); // 8 bit RGBA, no interlace
+
+    std::string png = "\x89PNG\r\n\x1a\n";
+    appendChunk(png, "IHDR", header);
+    appendChunk(png, "IDAT", zlib);
+    appendChunk(png, "IEND", "");
+    return png;
+}
+
+const std::string& runtimeDir() {
+    static const std::string dir = [] {
+        if (const char* xdg = getenv("XDG_RUNTIME_DIR"); xdg && *xdg)
+            return std::string(xdg);
+
+        std::string temp = "/tmp/hyprtoolkit-lua-XXXXXX";
+        if (!mkdtemp(temp.data()))
+            return std::string("/tmp"); // writeRuntimeFile still refuses existing names
+
+        // Removed at exit if everything in it was cleaned up
+        static std::string created = temp;
+        std::atexit([]() { rmdir(created.c_str()); });
+        return temp;
+    }();
+    return dir;
+}
+
+bool writeRuntimeFile(const std::string& path, std::string_view data) {
+    // Names are unique within a process, anything there is left over from an earlier
+    // one with our pid. Another user's file in a sticky /tmp can't be removed, and
+    // O_EXCL then refuses it.
+    unlink(path.c_str());
+
+    const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0)
+        return false;
+
+    size_t done = 0;
+    while (done < data.size()) {
+        const ssize_t n = write(fd, data.data() + done, data.size() - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        done += n;
+    }
+
+    const bool ok = close(fd) == 0 && done == data.size();
+    if (!ok)
+        unlink(path.c_str());
+    return ok;
+}
+
+std::string runtimeImagePath(const char* kind, uint64_t id, uint64_t generation) {
+    return runtimeDir() + "/hyprtoolkit-lua-" + kind + "-" + std::to_string(getpid()) + "-" + std::to_string(id) + "-" + std::to_string(generation) + ".png";
+}
+
+bool writeRuntimeImage(const std::string& path, const uint32_t* pixels, int width, int height) {
+    return writeRuntimeFile(path, encodePng(pixels, width, height));
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// CImageElement only loads from paths, so generated pixels (canvas rasters, image
+// buffers) reach it as PNG files in $XDG_RUNTIME_DIR. Those files live on tmpfs only
+// until the element has loaded them, so they are written uncompressed.
+
+namespace Hyprtoolkit::Lua {
+
+// Premultiplied ARGB32 (pixman a8r8g8b8 / cairo ARGB32), rows tightly packed
+std::string        encodePng(const uint32_t* pixels, int width, int height);
+
+// $XDG_RUNTIME_DIR, or without one a private (0700) directory made under /tmp once
+// per process, so no other user can predict or pre-create the names inside
+const std::string& runtimeDir();
+
+// Creates path exclusively, without following symlinks, mode 0600, and writes data.
+// Fails if anything already exists at path.
+bool               writeRuntimeFile(const std::string& path, std::string_view data);
+
+// <runtime dir>/hyprtoolkit-lua-<kind>-<pid>-<id>-<generation>.png
+std::string        runtimeImagePath(const char* kind, uint64_t id, uint64_t generation);
+
+bool               writeRuntimeImage(const std::string& path, const uint32_t* pixels, int width, int height);
+
+} // namespace Hyprtoolkit::Lua
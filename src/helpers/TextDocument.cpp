@@ -0,0 +1,181 @@
+#include "TextDocument.hpp"
+
+#include <algorithm>
+
+namespace Hyprtoolkit::Lua {
+
+static size_t countNewlines(std::string_view text) {
+    return std::count(text.begin(), text.end(), '\n');
+}
+
+CTextDocument::CTextDocument(std::string text) : m_original(std::move(text)) {
+    m_length   = m_original.size();
+    m_newlines = countNewlines(m_original);
+    if (m_length)
+        m_pieces.push_back(SPiece{false, 0, m_length, m_newlines});
+}
+
+size_t CTextDocument::length() const {
+    return m_length;
+}
+
+size_t CTextDocument::lineCount() const {
+    return m_newlines + 1;
+}
+
+size_t CTextDocument::pieceCount() const {
+    return m_pieces.size();
+}
+
+std::string_view CTextDocument::view(const SPiece& piece) const {
+    return std::string_view(piece.added ? m_added : m_original).substr(piece.start, piece.length);
+}
+
+std::string CTextDocument::text() const {
+    return sub(0, m_length);
+}
+
+std::string CTextDocument::sub(size_t offset, size_t count) const {
+    std::string result;
+    if (offset >= m_length)
+        return result;
+
+    count = std::min(count, m_length - offset);
+    result.reserve(count);
+
+    size_t pos = 0;
+    for (const auto& piece : m_pieces) {
+        if (result.size() == count)
+            break;
+        if (pos + piece.length > offset) {
+            const auto from = offset > pos ? offset - pos : 0;
+            result.append(view(piece).substr(from, count - result.size()));
+        }
+        pos += piece.length;
+    }
+    return result;
+}
+
+size_t CTextDocument::lineStart(size_t line) const {
+    if (line == 0)
+        return 0;
+    if (line > m_newlines)
+        return m_length;
+
+    size_t pos = 0;
+    for (const auto& piece : m_pieces) {
+        if (piece.newlines < line) {
+            line -= piece.newlines;
+            pos += piece.length;
+            continue;
+        }
+
+        const auto text = view(piece);
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] == '\n' && --line == 0)
+                return pos + i + 1;
+        }
+    }
+    return m_length;
+}
+
+size_t CTextDocument::split(size_t offset) {
+    size_t pos = 0;
+    for (size_t i = 0; i < m_pieces.size(); ++i) {
+        auto& piece = m_pieces[i];
+        if (pos == offset)
+            return i;
+
+        if (offset < pos + piece.length) {
+            const auto leftLength = offset - pos;
+            SPiece     right{piece.added, piece.start + leftLength, piece.length - leftLength, 0};
+            piece.length   = leftLength;
+            const auto nl  = countNewlines(view(piece));
+            right.newlines = piece.newlines - nl;
+            piece.newlines = nl;
+            m_pieces.insert(m_pieces.begin() + i + 1, right);
+            return i + 1;
+        }
+        pos += piece.length;
+    }
+    return m_pieces.size();
+}
+
+void CTextDocument::replace(size_t offset, size_t erase, std::string_view insert) {
+    offset = std::min(offset, m_length);
+    erase  = std::min(erase, m_length - offset);
+    if (erase == 0 && insert.empty())
+        return;
+
+    // Splitting at the end offset only inserts after `first`, which stays valid
+    const auto first = split(offset);
+    const auto last  = split(offset + erase);
+
+    for (auto i = first; i < last; ++i) {
+        m_newlines -= m_pieces[i].newlines;
+    }
+    m_pieces.erase(m_pieces.begin() + first, m_pieces.begin() + last);
+    m_length -= erase;
+
+    if (!insert.empty()) {
+        const auto nl = countNewlines(insert);
+
+        // Typing extends the piece of the previous keystroke instead of adding one
+        if (first > 0 && m_pieces[first - 1].added && m_pieces[first - 1].start + m_pieces[first - 1].length == m_added.size()) {
+            m_pieces[first - 1].length += insert.size();
+            m_pieces[first - 1].newlines += nl;
+        } else
+            m_pieces.insert(m_pieces.begin() + first, SPiece{true, m_added.size(), insert.size(), nl});
+
+        m_added.append(insert);
+        m_length += insert.size();
+        m_newlines += nl;
+    }
+
+    if (m_pieces.size() > MAX_PIECES)
+        compact();
+}
+
+void CTextDocument::compact() {
+    m_original = text();
+    m_added.clear();
+    m_pieces.clear();
+    if (m_length)
+        m_pieces.push_back(SPiece{false, 0, m_length, m_newlines});
+}
+
+STextEdit CTextDocument::sync(std::string_view next) {
+    const auto limit = std::min(m_length, next.size());
+
+    // Common prefix, a piece at a time
+    size_t prefix = 0;
+    for (const auto& piece : m_pieces) {
+        if (prefix == limit)
+            break;
+        const auto text = view(piece).substr(0, limit - prefix);
+        const auto diff = std::mismatch(text.begin(), text.end(), next.begin() + prefix).first - text.begin();
+        prefix += diff;
+        if ((size_t)diff < text.size())
+            break;
+    }
+
+    // Common suffix, not overlapping the prefix
+    size_t suffix = 0;
+    for (auto it = m_pieces.rbegin(); it != m_pieces.rend(); ++it) {
+        if (prefix + suffix == limit)
+            break;
+        const auto text = view(*it);
+        const auto take = std::min(text.size(), limit - prefix - suffix);
+        const auto tail = text.substr(text.size() - take);
+        const auto diff = std::mismatch(tail.rbegin(), tail.rend(), next.rbegin() + suffix).first - tail.rbegin();
+        suffix += diff;
+        if ((size_t)diff < take)
+            break;
+    }
+
+    STextEdit edit{prefix, m_length - prefix - suffix, std::string(next.substr(prefix, next.size() - prefix - suffix))};
+    replace(edit.offset, edit.erased, edit.inserted);
+    return edit;
+}
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Piece-table text model behind a textbox in delta mode. The text is a list of pieces
+// pointing into two buffers: the original text and an append-only buffer of
+// everything typed since. An edit splits at most two pieces and appends the inserted
+// bytes, so its cost follows the edit and the piece count, not the document size.
+
+namespace Hyprtoolkit::Lua {
+
+// One replacement: `erased` bytes at `offset` (0-based) became `inserted`
+struct STextEdit {
+    size_t      offset = 0;
+    size_t      erased = 0;
+    std::string inserted;
+
+    bool        empty() const {
+        return erased == 0 && inserted.empty();
+    }
+};
+
+class CTextDocument {
+  public:
+    explicit CTextDocument(std::string text = "");
+
+    size_t      length() const;
+    size_t      lineCount() const;
+    size_t      pieceCount() const;
+
+    // Whole text; prefer sub() on large documents
+    std::string text() const;
+    // Up to `count` bytes starting at `offset`, clamped to the document
+    std::string sub(size_t offset, size_t count) const;
+    // Byte offset where 0-based `line` starts, length() past the last line
+    size_t      lineStart(size_t line) const;
+
+    void        replace(size_t offset, size_t erase, std::string_view insert);
+
+    // Brings the document up to `next` and returns the edit that did it: the span
+    // between the longest common prefix and suffix. For a keystroke that is one byte.
+    STextEdit   sync(std::string_view next);
+
+  private:
+    struct SPiece {
+        bool   added    = false; // in m_added, else in m_original
+        size_t start    = 0;
+        size_t length   = 0;
+        size_t newlines = 0;
+    };
+
+    // Pieces past this are merged back into one original buffer
+    static constexpr size_t MAX_PIECES = 2048;
+
+    std::string_view        view(const SPiece& piece) const;
+    // Splits the piece containing offset, returns the index of the piece starting there
+    size_t                  split(size_t offset);
+    void                    compact();
+
+    std::string             m_original;
+    std::string             m_added;
+    std::vector<SPiece>     m_pieces;
+    size_t                  m_length   = 0;
+    size_t                  m_newlines = 0;
+};
+
+} // namespace Hyprtoolkit::Lua
@@ -0,0 +1,66 @@
+-- Headless smoke test, run by ctest under whichever VM the build links:
+--   hyprtoolkit-lua tests/vm_smoke.lua examples/*.lua
+-- Every example must compile, and the library behaviour the examples and the LuaJIT
+-- prelude rely on must give the same results on Lua 5.4 and LuaJIT. The examples
+-- themselves need a compositor, so their UI is not run here.
+
+local failures = 0
+
+local function check(name, got, want)
+    if got ~= want then
+        failures = failures + 1
+        print(string.format("FAIL %s: got %q, want %q", name, tostring(got), tostring(want)))
+    end
+end
+
+-- Examples: compile only, running them would open windows
+for i = 1, #arg do
+    local chunk, err = loadfile(arg[i])
+    if not chunk then
+        failures = failures + 1
+        print("FAIL compile " .. arg[i] .. ": " .. tostring(err))
+    end
+end
+
+-- Number formatting as the examples use it: floored values print without ".0"
+check("format %d floor", string.format("%d", math.floor(7.9)), "7")
+check("format %d%%", string.format("%d%%", math.floor(42.0)), "42%")
+check("tostring floor", tostring(math.floor(5 + 0.5)), "5")
+check("concat floor", "x" .. math.floor(3.2), "x3")
+check("uptime", string.format("%dd %dh %dm", math.floor(93784 / 86400), math.floor((93784 % 86400) / 3600), math.floor((93784 % 3600) / 60)), "1d 2h 3m")
+check("tonumber int", string.format("%d", tonumber("85")), "85")
+
+-- Library pieces the LuaJIT prelude provides
+check("math.type int", math.type(math.floor(2.5)), "integer")
+check("math.type float", math.type(2.5), "float")
+check("math.type other", math.type("1"), nil)
+check("math.tointeger", math.tointeger(3.0), 3)
+check("math.tointeger frac", math.tointeger(3.5), nil)
+check("table.unpack", select("#", table.unpack({ 1, 2, 3 })), 3)
+check("table.pack n", table.pack(1, nil, 3).n, 3)
+check("table.move", table.concat(table.move({ 1, 2, 3 }, 1, 3, 2), ","), "1,1,2,3")
+check("utf8.char", utf8.char(72, 228, 8364, 128512), "H\195\164\226\130\172\240\159\152\128")
+check("utf8.len", utf8.len("H\195\164\226\130\172"), 3)
+check("utf8.len bad", utf8.len("\255"), nil)
+check("utf8.codepoint", select(2, utf8.codepoint("H\195\164", 1, -1)), 228)
+check("utf8.offset", utf8.offset("H\195\164\226\130\172", 3), 4)
+
+local codes = {}
+for _, c in utf8.codes("a\195\164") do
+    codes[#codes + 1] = c
+end
+check("utf8.codes", table.concat(codes, ","), "97,228")
+
+-- goto, native on both
+local n = 0
+::again::
+n = n + 1
+if n < 3 then
+    goto again
+end
+check("goto", n, 3)
+
+if failures > 0 then
+    error(failures .. " smoke check(s) failed on " .. (jit and jit.version or _VERSION))
+end
+print("vm smoke passed on " .. (jit and jit.version or _VERSION))